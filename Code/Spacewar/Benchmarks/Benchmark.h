@@ -0,0 +1,71 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+/**
+ * The common helpers of the benchmarks. Each benchmark is a standalone program built
+ * from it's source file and the game sources it measures, which are listed in the file's
+ * header together with the build command. The paths are relative to this directory.
+ * The benchmarks are built with the optimizations, for example:
+ *
+ *   g++ -std=c++17 -O2 -I../Spacewar -I../../SFML-2.5.1/include -I../../pugixml
+ *       <Benchmark>.cpp <game sources> -lsfml-graphics -lsfml-system
+ *
+ * or with the same options in the Release configuration of a console project.
+ * The header replaces the global allocation functions to count the heap allocations,
+ * so it's included by the benchmark's source only.
+ */
+
+namespace Benchmark
+{
+	inline long g_numAllocations = 0;
+
+	/**
+	 * @function Measure
+	 * Run the function several times and return the best time of the run.
+	 * The best time is the least disturbed by the rest of the system.
+	 *
+	 * @param numRuns - number of the runs.
+	 * @param func - the measured function.
+	 * @return time of the fastest run in nanoseconds.
+	 */
+	template <typename Function>
+	double Measure(int numRuns, Function func)
+	{
+		double best = 0.0;
+		for (int i = 0; i < numRuns; ++i)
+		{
+			auto start = std::chrono::steady_clock::now();
+			func();
+			double time = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+			if (i == 0 || time < best)
+			{
+				best = time;
+			}
+		}
+		return best;
+	}
+}
+
+void* operator new(std::size_t size)
+{
+	++Benchmark::g_numAllocations;
+	if (void* p = std::malloc(size > 0 ? size : 1))
+	{
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
\ No newline at end of file
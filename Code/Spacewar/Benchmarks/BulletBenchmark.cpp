@@ -0,0 +1,124 @@
+/**
+ * The bullets' collision kernel benchmark. Tests 4096 random bullets' swept axes against
+ * the capsule targets in the same way CBulletSystem::Collide does (each bullet keeps the first
+ * target it hits) and reports the time per bullet-target pair of the scalar and the SSE2 kernels.
+ * Both kernels must find the same hits. The SSE2 kernel isn't built with SPACEWAR_NO_SIMD defined.
+ *
+ * Sources: BulletBenchmark.cpp (see Benchmark.h)
+ */
+
+#include "StdAfx.h"
+#include "LogicalSystem/SegmentDistance.h"
+#include "Benchmark.h"
+
+#include <random>
+
+static constexpr int NumBullets = 4096;
+static constexpr int NumTargets = 8;
+static constexpr int NumRounds = 2000;
+static constexpr int NumRuns = 5;
+static constexpr int NoHit = -1;
+
+struct SBullets
+{
+	std::vector<float> axisAX, axisAY, axisBX, axisBY, rad;
+	std::vector<int> hitTargets;
+};
+
+struct STarget
+{
+	float p2x, p2y, d2x, d2y, e, fRad;
+};
+
+static void CollideScalar(SBullets& bullets, const STarget& target, int t)
+{
+	for (int i = 0; i < NumBullets; ++i)
+	{
+		float fDistSq = SegmentsDistanceSq(bullets.axisAX[i], bullets.axisAY[i], bullets.axisBX[i], bullets.axisBY[i],
+			target.p2x, target.p2y, target.d2x, target.d2y, target.e);
+		float fWidth = bullets.rad[i] + target.fRad;
+		if (fDistSq <= fWidth * fWidth && bullets.hitTargets[i] == NoHit)
+		{
+			bullets.hitTargets[i] = t;
+		}
+	}
+}
+
+#ifdef BULLETS_SSE
+static void CollideSSE(SBullets& bullets, const STarget& target, int t)
+{
+	const __m128 vP2x = _mm_set1_ps(target.p2x);
+	const __m128 vP2y = _mm_set1_ps(target.p2y);
+	const __m128 vD2x = _mm_set1_ps(target.d2x);
+	const __m128 vD2y = _mm_set1_ps(target.d2y);
+	const __m128 vE = _mm_set1_ps(target.e);
+	const __m128 vTargetRad = _mm_set1_ps(target.fRad);
+
+	for (int i = 0; i < NumBullets; i += 4)
+	{
+		__m128 vDistSq = SegmentsDistanceSq(_mm_loadu_ps(&bullets.axisAX[i]), _mm_loadu_ps(&bullets.axisAY[i]),
+			_mm_loadu_ps(&bullets.axisBX[i]), _mm_loadu_ps(&bullets.axisBY[i]), vP2x, vP2y, vD2x, vD2y, vE);
+		__m128 vWidth = _mm_add_ps(_mm_loadu_ps(&bullets.rad[i]), vTargetRad);
+
+		if (int mask = _mm_movemask_ps(_mm_cmple_ps(vDistSq, _mm_mul_ps(vWidth, vWidth))))
+		{
+			for (int lane = 0; lane < 4; ++lane)
+			{
+				if ((mask & (1 << lane)) && bullets.hitTargets[i + lane] == NoHit)
+				{
+					bullets.hitTargets[i + lane] = t;
+				}
+			}
+		}
+	}
+}
+#endif
+
+int main()
+{
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> position(-1000.f, 1000.f);
+
+	// The bullets are swept by one tick of their flight, the targets are the spaceships' capsules
+	SBullets bullets;
+	for (int i = 0; i < NumBullets; ++i)
+	{
+		float x = position(random), y = position(random);
+		bullets.axisAX.push_back(x);
+		bullets.axisAY.push_back(y);
+		bullets.axisBX.push_back(x + 5.f);
+		bullets.axisBY.push_back(y + 20.f);
+		bullets.rad.push_back(5.f);
+	}
+
+	STarget targets[NumTargets];
+	for (int t = 0; t < NumTargets; ++t)
+	{
+		targets[t] = { 100.f * t, 50.f * t, 0.f, 20.f, 400.f, 15.f };
+	}
+
+	auto run = [&](const char* name, void (*collide)(SBullets&, const STarget&, int))
+	{
+		double time = Benchmark::Measure(NumRuns, [&]()
+		{
+			for (int round = 0; round < NumRounds; ++round)
+			{
+				bullets.hitTargets.assign(NumBullets, NoHit);
+				for (int t = 0; t < NumTargets; ++t)
+				{
+					collide(bullets, targets[t], t);
+				}
+			}
+		});
+
+		int numHits = (int)std::count_if(bullets.hitTargets.begin(), bullets.hitTargets.end(), [](int t) { return t != NoHit; });
+		printf("%-6s %5.2f ns/pair %d hits\n", name, time / NumRounds / NumBullets / NumTargets, numHits);
+		return bullets.hitTargets;
+	};
+
+	std::vector<int> hits = run("scalar", CollideScalar);
+#ifdef BULLETS_SSE
+	printf(run("SSE2", CollideSSE) == hits ? "same hits\n" : "different hits\n");
+#endif
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+/**
+ * The kinematics integration benchmark. Integrates the random state of 256, 4k and 64k entities
+ * (some of the slots are removed and some of the entities are at rest) and reports the time
+ * per entity. The SSE2 kernel is used where it's available, the scalar one is measured by
+ * the second build with SPACEWAR_NO_SIMD defined. Both kernels must print the same checksums.
+ *
+ * Sources: KinematicsBenchmark.cpp ../Spacewar/LogicalSystem/Kinematics.cpp
+ *   ../Spacewar/LogicalSystem/Gravity.cpp (see Benchmark.h)
+ */
+
+#include "StdAfx.h"
+#include "LogicalSystem/Kinematics.h"
+#include "Benchmark.h"
+
+#include <random>
+
+static constexpr float LevelSize = 1000.f;
+static constexpr float TimeStep = 1.f / 60.f;
+static constexpr int NumUpdates = 20000000;
+static constexpr int NumRuns = 5;
+
+static void Fill(CKinematics& kinematics, int numEntities)
+{
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> position(-10.f, LevelSize + 10.f);
+	std::uniform_real_distribution<float> speed(-300.f, 300.f);
+	std::uniform_real_distribution<float> angularSpeed(-400.f, 400.f);
+
+	for (int i = 0; i < numEntities; ++i)
+	{
+		int idx = kinematics.Add(i);
+		kinematics.SetPosition(idx, sf::Vector2f(position(random), position(random)));
+		kinematics.SetVelocity(idx, sf::Vector2f(speed(random), i % 7 == 0 ? 0.f : speed(random)));
+		kinematics.SetAngularSpeed(idx, i % 5 == 0 ? 0.f : angularSpeed(random));
+		kinematics.SetRotation(idx, position(random));
+		if (i % 11 == 0)
+		{
+			kinematics.Remove(idx);
+		}
+	}
+}
+
+int main()
+{
+#if !defined(SPACEWAR_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	printf("SSE2 kernel\n");
+#else
+	printf("scalar kernel\n");
+#endif
+
+	for (int numEntities : { 256, 4096, 65536 })
+	{
+		const int numPasses = NumUpdates / numEntities;
+
+		CKinematics kinematics;
+		Fill(kinematics, numEntities);
+
+		double time = Benchmark::Measure(NumRuns, [&]()
+		{
+			for (int i = 0; i < numPasses; ++i)
+			{
+				kinematics.Integrate(TimeStep, LevelSize);
+			}
+		});
+
+		// The checksum of the state after the same number of the passes
+		CKinematics reference;
+		Fill(reference, numEntities);
+		for (int i = 0; i < numPasses; ++i)
+		{
+			reference.Integrate(TimeStep, LevelSize);
+		}
+
+		double checksum = 0.0;
+		for (int i = 0; i < numEntities; ++i)
+		{
+			checksum += reference.GetPosition(i).x + reference.GetPosition(i).y + reference.GetRotation(i);
+		}
+
+		printf("%6d entities %5.2f ns/entity checksum %.3f\n", numEntities, time / numPasses / numEntities, checksum);
+	}
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,174 @@
+/**
+ * The spatial queries benchmark. Runs the AABB, radius and raycast queries the same way
+ * CPhysicalSystem does (the broadphase query and the exact test of the candidates)
+ * over the random scenes with each broadphase. The brute force broadphase is the linear
+ * reference, the numbers of the found entities must be the same for all the broadphases.
+ *
+ * Sources: QueryBenchmark.cpp ../Spacewar/PhysicalSystem/Broadphase.cpp ../Spacewar/PhysicalSystem/SweepAndPrune.cpp
+ *   ../Spacewar/PhysicalSystem/UniformGrid.cpp ../Spacewar/PhysicalSystem/PhysicalPrimitive.cpp (see Benchmark.h)
+ */
+
+#include "StdAfx.h"
+#include "PhysicalSystem/Broadphase.h"
+#include "PhysicalSystem/SweepAndPrune.h"
+#include "PhysicalSystem/PhysicalPrimitive.h"
+#include "Benchmark.h"
+
+#include <random>
+
+using namespace PhysicalPrimitive;
+
+static constexpr float LevelSize = 1500.f;
+static constexpr float GridCellSize = 100.f;
+static constexpr int NumQueries = 2000;
+static constexpr int NumRuns = 5;
+
+struct SQuery
+{
+	sf::Vector2f vPos;
+	sf::Vector2f vDir;
+};
+
+// The scene of the circles and the capsules indexed by the proxies' SmartIds
+struct SScene
+{
+	std::vector<std::unique_ptr<IPrimitive>> primitives;
+	std::vector<SmartId> candidates;
+};
+
+static int RunAABBQuery(IBroadphase& broadphase, SScene& scene, const SQuery& query)
+{
+	sf::FloatRect bounds(query.vPos.x - 50.f, query.vPos.y - 50.f, 100.f, 100.f);
+
+	scene.candidates.clear();
+	broadphase.Query(bounds, scene.candidates);
+
+	int numResults = 0;
+	for (SmartId sid : scene.candidates)
+	{
+		numResults += bounds.intersects(scene.primitives[sid]->GetBoundingBox());
+	}
+	return numResults;
+}
+
+static int RunRadiusQuery(IBroadphase& broadphase, SScene& scene, const SQuery& query)
+{
+	Circle probe(query.vPos, 50.f);
+
+	scene.candidates.clear();
+	broadphase.Query(probe.GetBoundingBox(), scene.candidates);
+
+	int numResults = 0;
+	for (SmartId sid : scene.candidates)
+	{
+		const IPrimitive* pPrimitive = scene.primitives[sid].get();
+		numResults += g_intersectionsTable[EPrimitiveType_Circle][pPrimitive->GetType()](&probe, pPrimitive);
+	}
+	return numResults;
+}
+
+static int RunRaycast(IBroadphase& broadphase, SScene& scene, const SQuery& query)
+{
+	float fMaxDist = 300.f;
+	sf::Vector2f vEnd = query.vPos + query.vDir * fMaxDist;
+	sf::FloatRect bounds(std::min(query.vPos.x, vEnd.x), std::min(query.vPos.y, vEnd.y),
+		std::abs(vEnd.x - query.vPos.x), std::abs(vEnd.y - query.vPos.y));
+
+	scene.candidates.clear();
+	broadphase.Query(bounds, scene.candidates);
+
+	bool bHit = false;
+	for (SmartId sid : scene.candidates)
+	{
+		float fDist;
+		const IPrimitive* pPrimitive = scene.primitives[sid].get();
+		if (g_raycastTable[pPrimitive->GetType()](pPrimitive, query.vPos, query.vDir, fMaxDist, fDist))
+		{
+			fMaxDist = fDist;
+			bHit = true;
+		}
+	}
+	return bHit;
+}
+
+int main()
+{
+	for (int numEntities : { 1000, 10000 })
+	{
+		std::mt19937 random(5);
+		std::uniform_real_distribution<float> position(0.f, LevelSize);
+		std::uniform_real_distribution<float> angle(0.f, 360.f);
+		std::uniform_real_distribution<float> size(5.f, 30.f);
+
+		SScene scene;
+		CBruteForceBroadphase bruteForce;
+		CGridBroadphase grid(GridCellSize);
+		CSweepAndPrune sweepAndPrune;
+		IBroadphase* broadphases[] = { &bruteForce, &grid, &sweepAndPrune };
+		const char* names[] = { "brute force", "grid", "sweep and prune" };
+
+		grid.SetLevelSize(LevelSize);
+
+		for (int i = 0; i < numEntities; ++i)
+		{
+			sf::Transform transform;
+			transform.translate(position(random), position(random)).rotate(angle(random));
+
+			std::unique_ptr<IPrimitive> pLocal;
+			if (i % 2 == 0)
+			{
+				pLocal = std::make_unique<Circle>(size(random));
+			}
+			else
+			{
+				float fHalfHeight = size(random);
+				pLocal = std::make_unique<Capsule>(sf::Vector2f(0.f, -fHalfHeight), sf::Vector2f(0.f, fHalfHeight), 0.5f * size(random));
+			}
+
+			std::unique_ptr<IPrimitive> pPrimitive = pLocal->Clone();
+			pPrimitive->Transform(*pLocal, transform);
+			for (IBroadphase* pBroadphase : broadphases)
+			{
+				pBroadphase->AddProxy(i, pPrimitive->GetBoundingBox(), SCollisionFilter());
+			}
+			scene.primitives.push_back(std::move(pPrimitive));
+		}
+
+		std::vector<SQuery> queries(NumQueries);
+		for (SQuery& query : queries)
+		{
+			float fAngle = angle(random) * 3.14159265f / 180.f;
+			query.vPos = sf::Vector2f(position(random), position(random));
+			query.vDir = sf::Vector2f(cosf(fAngle), sinf(fAngle));
+		}
+
+		printf("%d entities, us per query (found entities):\n", numEntities);
+
+		auto run = [&](const char* name, int (*query)(IBroadphase&, SScene&, const SQuery&))
+		{
+			printf("  %-8s", name);
+			for (int i = 0; i < 3; ++i)
+			{
+				// The first query fills the grid
+				query(*broadphases[i], scene, queries.front());
+
+				long numFound = 0;
+				double time = Benchmark::Measure(NumRuns, [&]()
+				{
+					numFound = 0;
+					for (const SQuery& q : queries)
+					{
+						numFound += query(*broadphases[i], scene, q);
+					}
+				});
+				printf(" %s %7.2f (%ld)", names[i], time / 1000.0 / NumQueries, numFound);
+			}
+			printf("\n");
+		};
+
+		run("AABB", RunAABBQuery);
+		run("radius", RunRadiusQuery);
+		run("raycast", RunRaycast);
+	}
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "StdAfx.h"
+#include "AllocationCounter.h"
+
+#include <cstdlib>
+#include <new>
+
+#ifdef SPACEWAR_COUNT_ALLOCATIONS
+
+static thread_local int64_t s_dNumAllocations = 0;
+
+// The array and the nothrow versions call this one, the over-aligned allocations aren't counted
+void* operator new(std::size_t size)
+{
+	++s_dNumAllocations;
+	if (void* p = std::malloc(size > 0 ? size : 1))
+	{
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+bool AllocationCounter::IsEnabled()
+{
+	return true;
+}
+
+int64_t AllocationCounter::GetNumAllocations()
+{
+	return s_dNumAllocations;
+}
+
+#else
+
+bool AllocationCounter::IsEnabled()
+{
+	return false;
+}
+
+int64_t AllocationCounter::GetNumAllocations()
+{
+	return 0;
+}
+
+#endif
+
+void CAllocationCheck::Begin()
+{
+	m_dStart = AllocationCounter::GetNumAllocations();
+}
+
+void CAllocationCheck::End()
+{
+	if (!AllocationCounter::IsEnabled() || ++m_numCalls <= m_numWarmUpCalls)
+	{
+		return;
+	}
+
+	m_dNumAllocations += AllocationCounter::GetNumAllocations() - m_dStart;
+	if ((m_numCalls - m_numWarmUpCalls) % m_numReportCalls == 0)
+	{
+		Log(m_name, ": ", m_dNumAllocations, " heap allocations in ", m_numReportCalls, " calls");
+		m_dNumAllocations = 0;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+
+// The global allocation functions are replaced only with SPACEWAR_COUNT_ALLOCATIONS defined
+// (see AllocationCounter.cpp), so the regular debug builds keep the CRT debug heap
+
+namespace AllocationCounter
+{
+	bool IsEnabled();
+
+	// The number of the heap allocations made by the calling thread so far, zero if the counter is disabled
+	int64_t GetNumAllocations();
+}
+
+/**
+ * @class CAllocationCheck
+ * Check of the code path, which shouldn't allocate the memory in the steady state.
+ * The first calls of the path are the warm-up (e.g. the pools and the arrays are growing),
+ * the heap allocations of the rest of the calls are counted and logged once per
+ * the specified number of the calls. Does nothing if the counter is disabled.
+ * The allocations are counted on the calling thread only, so the checked path
+ * must begin and end on the same thread.
+ */
+class CAllocationCheck
+{
+public:
+
+	// Counts the allocations of the path from the scope's construction to it's destruction
+	class CScope
+	{
+	public:
+
+		CScope(CAllocationCheck& check) : m_check(check) { m_check.Begin(); }
+		CScope(const CScope&) = delete;
+		~CScope() { m_check.End(); }
+
+	private:
+
+		CAllocationCheck& m_check;
+	};
+
+	CAllocationCheck(const char* name, int numWarmUpCalls, int numReportCalls)
+		: m_name(name), m_numWarmUpCalls(numWarmUpCalls), m_numReportCalls(numReportCalls) {}
+	CAllocationCheck(const CAllocationCheck&) = delete;
+
+	void Begin();
+	void End();
+
+private:
+
+	const char* m_name;
+	int m_numWarmUpCalls;
+	int m_numReportCalls;
+	int m_numCalls = 0;
+	int64_t m_dStart = 0;
+	int64_t m_dNumAllocations = 0;
+};
\ No newline at end of file
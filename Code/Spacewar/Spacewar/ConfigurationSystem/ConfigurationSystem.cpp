@@ -15,6 +15,7 @@ CConfigurationSystem::CConfigurationSystem(const std::filesystem::path& path)
 	, m_pFeedbackConfiguration(std::make_unique<CFeedbackConfiguration>(path / "Feedback.xml"))
 {
 	LoadWindowConfiguration(path / "Window.xml");
+	LoadPhysicsConfiguration(path / "Physics.xml");
 }
 
 void CConfigurationSystem::LoadWindowConfiguration(const std::filesystem::path& path)
@@ -39,6 +40,50 @@ void CConfigurationSystem::LoadWindowConfiguration(const std::filesystem::path&
 	m_windowConfiguration.resY = root.attribute("resY").as_int(m_windowConfiguration.resY);
 	m_windowConfiguration.bVerticalSynq = root.attribute("verticalSynq").as_bool(m_windowConfiguration.bVerticalSynq);
 	m_windowConfiguration.frameLitimit = root.attribute("frameLimit").as_int(m_windowConfiguration.frameLitimit);
+	m_windowConfiguration.fixedTickRate = std::max(0, root.attribute("fixedTickRate").as_int(m_windowConfiguration.fixedTickRate));
+	m_windowConfiguration.maxCatchUpTicks = std::max(1, root.attribute("maxCatchUpTicks").as_int(m_windowConfiguration.maxCatchUpTicks));
+	m_windowConfiguration.numWorkers = std::max(-1, root.attribute("numWorkers").as_int(m_windowConfiguration.numWorkers));
+	m_windowConfiguration.bSerialFrame = root.attribute("serialFrame").as_bool(m_windowConfiguration.bSerialFrame);
+	m_windowConfiguration.fStatisticsPeriod = std::max(0.f, root.attribute("statisticsPeriod").as_float(m_windowConfiguration.fStatisticsPeriod));
+}
+
+void CConfigurationSystem::LoadPhysicsConfiguration(const std::filesystem::path& path)
+{
+	pugi::xml_document doc;
+
+	auto res = doc.load_file(path.c_str());
+	if (!res)
+	{
+		Log("Failed to load physics configuration: ", res.description());
+		return;
+	}
+
+	auto root = doc.child("Physics");
+	if (!root)
+	{
+		Log("Invalid root element in physics configuration");
+		return;
+	}
+
+	std::string broadphase = root.attribute("broadphase").value();
+	if (broadphase == "BruteForce")
+	{
+		m_physicsConfiguration.broadphase = SPhysicsConfiguration::BruteForce;
+	}
+	else if (broadphase == "Grid")
+	{
+		m_physicsConfiguration.broadphase = SPhysicsConfiguration::Grid;
+	}
+	else if (broadphase == "SweepAndPrune")
+	{
+		m_physicsConfiguration.broadphase = SPhysicsConfiguration::SweepAndPrune;
+	}
+	else if (!broadphase.empty())
+	{
+		Log("Invalid broadphase type ", broadphase, " specified in physics configuration");
+	}
+
+	m_physicsConfiguration.fGridCellSize = root.attribute("cellSize").as_float(m_physicsConfiguration.fGridCellSize);
 }
 
 CConfigurationSystem::~CConfigurationSystem() = default;
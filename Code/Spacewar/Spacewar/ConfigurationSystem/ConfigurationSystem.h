@@ -30,6 +30,29 @@ public:
 		int resY = 1000;
 		bool bVerticalSynq = true;
 		int frameLitimit = 60;
+		// The simulation's tick rate, the simulation is stepped once per frame if it's zero
+		int fixedTickRate = 0;
+		// The maximal number of the ticks per frame, the rest of the frame time is dropped
+		int maxCatchUpTicks = 4;
+		// The number of the task scheduler's workers besides the main thread, -1 to take one per the spare core
+		int numWorkers = -1;
+		// Debug mode running the frame's tasks one by one on the main thread
+		bool bSerialFrame = false;
+		// The period in seconds of logging the threads' utilization and the systems' statistics, zero to disable
+		float fStatisticsPeriod = 0.f;
+	};
+
+	struct SPhysicsConfiguration
+	{
+		enum EBroadphase : uint8_t
+		{
+			BruteForce,
+			Grid,
+			SweepAndPrune,
+		};
+
+		EBroadphase broadphase = Grid;
+		float fGridCellSize = 100.f;
 	};
 
 	const CEntityConfiguration* GetEntityConfiguration() const { return m_pEntityConfiguration.get(); }
@@ -38,12 +61,14 @@ public:
 	const CPlayerConfiguration* GetPlayerConfiguration() const { return m_pPlayerConfiguration.get(); }
 	const CFeedbackConfiguration* GetFeedbackConfiguration() const { return m_pFeedbackConfiguration.get(); }
 	const SWindowConfiguration& GetWindowConfiguration() const { return m_windowConfiguration; }
+	const SPhysicsConfiguration& GetPhysicsConfiguration() const { return m_physicsConfiguration; }
 
 public:
 
 	static sf::Color ParseColor(const std::string& color);
 
 	void LoadWindowConfiguration(const std::filesystem::path& path);
+	void LoadPhysicsConfiguration(const std::filesystem::path& path);
 
 private:
 
@@ -53,4 +78,5 @@ private:
 	std::unique_ptr<CPlayerConfiguration> m_pPlayerConfiguration;
 	std::unique_ptr<CFeedbackConfiguration> m_pFeedbackConfiguration;
 	SWindowConfiguration m_windowConfiguration;
+	SPhysicsConfiguration m_physicsConfiguration;
 };
\ No newline at end of file
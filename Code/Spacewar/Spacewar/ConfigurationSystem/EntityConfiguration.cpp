@@ -3,6 +3,8 @@
 #include "Game.h"
 #include "ResourceSystem.h"
 
+#include <algorithm>
+
 inline static PhysicalPrimitive::EPrimitiveType ParsePrimitiveType(const std::string& type)
 {
 	if (type == "Circle")
@@ -20,9 +22,82 @@ inline static PhysicalPrimitive::EPrimitiveType ParsePrimitiveType(const std::st
 	return PhysicalPrimitive::EPrimitiveType_Num;
 }
 
+void CEntityConfiguration::ParseCollisionLayers(const pugi::xml_node& node)
+{
+	auto layers = node.children("Layer");
+	for (auto layer = layers.begin(); layer != layers.end(); ++layer)
+	{
+		std::string name = layer->attribute("name").value();
+		if (m_collisionLayers.find(name) != m_collisionLayers.end())
+		{
+			Log("Collision layer with name ", name, " already exists");
+			continue;
+		}
+
+		if (m_collisionLayers.size() >= SCollisionFilter::MaxLayers)
+		{
+			Log("Too many collision layers, layer ", name, " is ignored");
+			break;
+		}
+
+		m_collisionLayers.emplace(std::move(name), (int)m_collisionMasks.size());
+		m_collisionMasks.push_back(0);
+	}
+
+	for (auto layer = layers.begin(); layer != layers.end(); ++layer)
+	{
+		auto fnd = m_collisionLayers.find(layer->attribute("name").value());
+		if (fnd == m_collisionLayers.end())
+		{
+			continue;
+		}
+
+		std::string collides = layer->attribute("collides").value();
+		size_t start = 0;
+		while (start < collides.size())
+		{
+			size_t end = collides.find(',', start);
+			if (end == std::string::npos)
+			{
+				end = collides.size();
+			}
+
+			std::string other = collides.substr(start, end - start);
+			auto otherFnd = m_collisionLayers.find(other);
+			if (otherFnd != m_collisionLayers.end())
+			{
+				m_collisionMasks[fnd->second] |= 1u << otherFnd->second;
+				m_collisionMasks[otherFnd->second] |= 1u << fnd->second;
+			}
+			else
+			{
+				Log("Invalid collision layer ", other, " specified for layer ", fnd->first);
+			}
+
+			start = end + 1;
+		}
+	}
+}
+
 void CEntityConfiguration::ParsePhysics(const pugi::xml_node& node, const std::string& name, CEntityConfiguration::SEntityClass& entityClass)
 {
 	entityClass.physicsType = ParsePrimitiveType(node.attribute("type").value());
+	entityClass.bFastPhysics = node.attribute("fast").as_bool();
+
+	if (auto layer = node.attribute("layer"))
+	{
+		auto fnd = m_collisionLayers.find(layer.value());
+		if (fnd != m_collisionLayers.end())
+		{
+			entityClass.collisionFilter.layer = 1u << fnd->second;
+			entityClass.collisionFilter.mask = m_collisionMasks[fnd->second];
+		}
+		else
+		{
+			Log("Invalid collision layer ", layer.value(), " specified for entity ", name);
+		}
+	}
+
 	if (entityClass.physicsType != PhysicalPrimitive::EPrimitiveType_Num)
 	{
 		switch (entityClass.physicsType)
@@ -48,6 +123,12 @@ void CEntityConfiguration::ParsePhysics(const pugi::xml_node& node, const std::s
 			{
 				vertices.push_back(iter->attribute("coords").as_vector());
 			}
+
+			if (vertices.size() > PhysicalPrimitive::Polygon::MaxVertices)
+			{
+				Log("Too many vertices specified for entity ", name);
+				vertices.resize(PhysicalPrimitive::Polygon::MaxVertices);
+			}
 			entityClass.pPhysics = std::make_unique<CEntityConfiguration::PolygonConfig>(std::move(vertices));
 		}
 		break;
@@ -91,7 +172,13 @@ CEntityConfiguration::CEntityConfiguration(const std::filesystem::path& path)
 		return;
 	}
 
-	for (auto iter = root.begin(); iter != root.end(); ++iter)
+	if (auto collisionLayers = root.child("CollisionLayers"))
+	{
+		ParseCollisionLayers(collisionLayers);
+	}
+
+	auto entities = root.children("Entity");
+	for (auto iter = entities.begin(); iter != entities.end(); ++iter)
 	{
 		std::string name = iter->attribute("name").value();
 		if (!name.empty())
@@ -104,6 +191,8 @@ CEntityConfiguration::CEntityConfiguration(const std::filesystem::path& path)
 			}
 
 			SEntityClass entityClass;
+			entityClass.poolSize = std::max(0, iter->attribute("poolSize").as_int());
+			entityClass.bGravity = iter->attribute("gravity").as_bool();
 
 			auto physics = iter->child("Physics");
 			if (physics)
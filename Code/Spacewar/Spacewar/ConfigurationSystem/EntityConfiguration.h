@@ -2,6 +2,7 @@
 
 #include "LogicalSystem/LogicalEntity.h"
 #include "PhysicalSystem/PhysicalPrimitive.h"
+#include "PhysicalSystem/CollisionFilter.h"
 
 #include <filesystem>
 #include <map>
@@ -40,16 +41,26 @@ public:
 	struct PolygonConfig : public IPrimitiveConfig
 	{
 		PolygonConfig(std::vector<sf::Vector2f>&& _vertices)
-			: vertices(_vertices) {}
+			: vertices(_vertices)
+		{
+			PhysicalPrimitive::CalculateNormals(vertices, normals);
+		}
 
 		std::vector<sf::Vector2f> vertices;
+		std::vector<sf::Vector2f> normals;
 	};
 
 	struct SEntityClass
 	{
 		PhysicalPrimitive::EPrimitiveType physicsType = PhysicalPrimitive::EPrimitiveType_Num;
 		std::unique_ptr<IPrimitiveConfig> pPhysics;
+		SCollisionFilter collisionFilter;
+		bool bFastPhysics = false;
 		std::vector<CLogicalEntity::SRenderSlot> renderSlots;
+		// The maximal number of the removed entities of the class kept for the reuse
+		int poolSize = 0;
+		// If the entities of the class are pulled by the holes
+		bool bGravity = false;
 	};
 
 	CEntityConfiguration(const std::filesystem::path& path);
@@ -59,10 +70,16 @@ public:
 
 private:
 
+	void ParseCollisionLayers(const pugi::xml_node& node);
 	void ParsePhysics(const pugi::xml_node& node, const std::string& name, SEntityClass& entityClass);
 	CLogicalEntity::SRenderSlot ParseRender(const pugi::xml_node& node, const std::string& name);
 
 private:
 
 	std::map<std::string, SEntityClass> m_entityClasses;
+
+	// Collision layers' indices and the masks of the layers they collide with.
+	// The collision matrix is symmetric.
+	std::map<std::string, int> m_collisionLayers;
+	std::vector<uint32_t> m_collisionMasks;
 };
\ No newline at end of file
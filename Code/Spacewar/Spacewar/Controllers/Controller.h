@@ -95,7 +95,8 @@ protected:
 	 * 
 	 * @param f - processing function which the event listeners is applied to.
 	 */
-	inline void ForEachListener(std::function<void(IControllerEventListener*)> f)
+	template <typename F>
+	inline void ForEachListener(F&& f)
 	{
 		for (auto iter = m_listeners.begin(); iter != m_listeners.end();)
 		{
@@ -3,10 +3,59 @@
 #include <vector>
 #include <algorithm>
 #include <functional>
+#include <utility>
+#include <type_traits>
+
+class CTaskScheduler;
 
 typedef int SmartId;
 static constexpr const int InvalidLink = -1;
 
+/**
+ * SmartId consists of the index of the link slot in the lower bits and
+ * the generation of this slot in the upper ones. The generation is increased
+ * each time the slot is released, so the SmartIds of the removed entities
+ * never match the new entities, linked to the same slot later.
+ * The upper bit is always zero to keep the SmartIds positive.
+ * The index bits cover far more entities than any of the systems has,
+ * the rest are given to the generation, so it wraps around as rarely as possible.
+ */
+static constexpr const int SmartIdIndexBits = 16;
+static constexpr const int SmartIdIndexMask = (1 << SmartIdIndexBits) - 1;
+static constexpr const int SmartIdGenerationMask = (1 << (31 - SmartIdIndexBits)) - 1;
+
+inline int GetSmartIdIndex(SmartId sid)
+{
+	return sid & SmartIdIndexMask;
+}
+
+inline int GetSmartIdGeneration(SmartId sid)
+{
+	return (sid >> SmartIdIndexBits) & SmartIdGenerationMask;
+}
+
+inline SmartId MakeSmartId(int idx, int generation)
+{
+	return (SmartId)(((generation & SmartIdGenerationMask) << SmartIdIndexBits) | (idx & SmartIdIndexMask));
+}
+
+/**
+ * The storage of the other elements of the same kind as the storage of the entities.
+ * The containers providing the Rebind alias (see CSegmentedVector) are rebound,
+ * the others are replaced by std::vector.
+ */
+template <typename Storage, typename U, typename = void>
+struct SRebindStorage
+{
+	using Type = std::vector<U>;
+};
+
+template <typename Storage, typename U>
+struct SRebindStorage<Storage, U, std::void_t<typename Storage::template Rebind<U>>>
+{
+	using Type = typename Storage::template Rebind<U>;
+};
+
 /**
  * @class CEntity
  * This base class allows its heirs to be part of CEntitySystem (see below).
@@ -30,7 +79,11 @@ private:
  * The base class providing effective storing and processing the entities.
  * All the entities are sored in one array to guarantee fast iterating over them.
  * A entity can be accessed via special it's unique identifier - SmartId.
- * SmartIds are simply the indices of an array storing indices of the entity array.
+ * SmartIds are the indices of an array storing indices of the entity array (links),
+ * combined with the generation of the link. The released links form an intrusive
+ * free queue, so creating an entity never searches for a free link. The queue is
+ * first in first out and a link is reused only when enough of them are released,
+ * so the generation of a link wraps around after a lot of the other entities are removed.
  * SmartIds allows to rearrange the entities while operating them in their array
  * without invalidating identifiers outside of the system.
  * CEntitySystem can be thread safe since the new entities are being added only in the
@@ -40,8 +93,13 @@ private:
  * 
  * @template param T - type of the entities, contained in the system. Must be inheritor of CEntity.
  * @template param SafeRemive - by enabling, enforce the system to use safe removing.
+ * @template param Storage - container of the entities. It should provide the subset
+ * of the std::vector interface: reserve, size, max_size, operator[], emplace_back, pop_back and clear.
+ * If the entities are accessed from the other thread while the new ones are created,
+ * the container should never relocate the existing entities (see CSegmentedVector).
+ * The links are stored in the same kind of the container, so they never relocate too.
  */
-template <typename T, bool SafeRemove>
+template <typename T, bool SafeRemove, typename Storage = std::vector<T>>
 class CEntitySystem
 {
 public:
@@ -68,20 +126,23 @@ public:
 	template <typename... V>
 	SmartId CreateEntity(V&&... args)
 	{
-		SmartId sid = InvalidLink;
-
-		auto fnd = std::find(m_smartLinks.begin(), m_smartLinks.end(), InvalidLink);
-		if (fnd != m_smartLinks.end())
+		if (m_entities.size() >= m_entities.max_size())
 		{
-			*fnd = (int)m_entities.size();
-			sid = (SmartId)(fnd - m_smartLinks.begin());
+			Log("The entity storage is full");
+			return InvalidLink;
 		}
-		else
+
+		int idx = AllocateLink();
+		if (idx == InvalidLink)
 		{
-			m_smartLinks.push_back((int)m_entities.size());
-			sid = (SmartId)(m_smartLinks.size() - 1);
+			Log("The SmartIds are exhausted");
+			return InvalidLink;
 		}
 
+		SSmartLink& link = m_smartLinks[idx];
+		link.entity = (int)m_entities.size();
+		SmartId sid = MakeSmartId(idx, link.generation);
+
 		m_entities.emplace_back(std::forward<V>(args)...).SetId(sid);
 
 		return sid;
@@ -99,15 +160,14 @@ public:
 	*/
 	virtual void RemoveEntity(SmartId sid, bool immediate = false)
 	{
-		if (sid < m_smartLinks.size() && m_smartLinks[sid] != InvalidLink)
+		if (IsValid(sid))
 		{
-			if (SafeRemove || !immediate)
-			{
-				UnlinkEntity(sid);
-			}
-			else
+			int entity = m_smartLinks[GetSmartIdIndex(sid)].entity;
+			UnlinkEntity(GetSmartIdIndex(sid));
+
+			if (!SafeRemove && immediate)
 			{
-				DeleteEntity(m_smartLinks[sid]);
+				DeleteEntity(entity);
 			}
 		}
 	}
@@ -119,9 +179,9 @@ public:
 	*/
 	virtual void Clear()
 	{
-		for (SmartId i = 0; i < m_smartLinks.size(); ++i)
+		for (int i = 0; i < m_smartLinks.size(); ++i)
 		{
-			if (m_smartLinks[i] != InvalidLink)
+			if (m_smartLinks[i].entity != InvalidLink)
 			{
 				UnlinkEntity(i);
 			}
@@ -136,19 +196,46 @@ public:
 	/**
 	* @function GetEntity
 	* Returns a pointer to the entity linked to the SmartId if it's valid.
+	* The SmartIds of the removed entities are never valid, even if their
+	* link slots are used by the other entities.
 	* 
 	* @param sid - SmartId of the entity.
 	* @return A pointer to the entity linked to the SmartId or nullptr.
 	*/
 	inline T* GetEntity(SmartId sid)
 	{
-		if (sid >= 0 && sid < m_smartLinks.size() && m_smartLinks[sid] != InvalidLink)
+		if (IsValid(sid))
 		{
-			return &m_entities[m_smartLinks[sid]];
+			return &m_entities[m_smartLinks[GetSmartIdIndex(sid)].entity];
 		}
 		return nullptr;
 	}
 
+	/**
+	* @function ReissueId
+	* Link the entity to the new SmartId without moving it. The old SmartId
+	* becomes invalid, as if the entity was removed. Used to recycle the entities.
+	* The entity keeps it's link, so the data indexed by the link stays valid.
+	* 
+	* @param sid - SmartId of the entity.
+	* @return The new SmartId of the entity or InvalidLink if the SmartId is invalid.
+	*/
+	SmartId ReissueId(SmartId sid)
+	{
+		if (!IsValid(sid))
+		{
+			return InvalidLink;
+		}
+
+		int idx = GetSmartIdIndex(sid);
+		SSmartLink& link = m_smartLinks[idx];
+		link.generation = (link.generation + 1) & SmartIdGenerationMask;
+
+		SmartId newSid = MakeSmartId(idx, link.generation);
+		m_entities[link.entity].SetId(newSid);
+		return newSid;
+	}
+
 	/**
 	* @function GetNumEntities
 	* Returns the current number of the entities in the container.
@@ -164,9 +251,11 @@ public:
 	* @function ForEachEntity
 	* Function to iterate over the valid entities in the container.
 	* 
+	* @template param F - type of the function, so the calls can be inlined.
 	* @param f - function, which is applied to every entity.
 	*/
-	inline void ForEachEntity(std::function<void(T&)> f)
+	template <typename F>
+	inline void ForEachEntity(F&& f)
 	{
 		for (int i = 0; i < m_entities.size(); ++i)
 		{
@@ -177,6 +266,34 @@ public:
 		}
 	}
 
+	/**
+	* @function ForEachEntityParallel
+	* Function to iterate over the valid entities in the container in parallel.
+	* The container is split into the chunks processed by the task scheduler.
+	* The function must not depend on the other entities' processing, create
+	* or remove the entities and access the shared data without synchronization.
+	* 
+	* @template param Scheduler - CTaskScheduler, which is only declared here,
+	* so the callers include TaskScheduler.h.
+	* @param scheduler - task scheduler processing the chunks.
+	* @param f - function, which is applied to every entity.
+	* @param chunkSize - number of the entities in a chunk.
+	*/
+	template <typename F, typename Scheduler = CTaskScheduler>
+	void ForEachEntityParallel(Scheduler& scheduler, F&& f, int chunkSize = 64)
+	{
+		scheduler.ParallelFor(GetNumEntities(), chunkSize, [this, &f](int begin, int end, int)
+			{
+				for (int i = begin; i < end; ++i)
+				{
+					if (m_entities[i].GetId() != InvalidLink)
+					{
+						f(m_entities[i]);
+					}
+				}
+			});
+	}
+
 	/**
 	* @function CollectGarbage
 	* Delete all the unlinked entities from the container.
@@ -186,35 +303,109 @@ public:
 	*/
 	virtual void CollectGarbage()
 	{
-		for (int i = 0; i < m_entities.size(); ++i)
+		for (int i = 0; i < m_entities.size();)
 		{
+			// The last entity is moved in place of the deleted one, so it should be checked too
 			if (m_entities[i].GetId() == InvalidLink)
 			{
 				DeleteEntity(i);
 			}
+			else
+			{
+				++i;
+			}
 		}
 	}
 
 private:
 
-	inline void UnlinkEntity(SmartId sid)
+	// The number of the released links, which are queued before the first one is reused
+	static constexpr int MinFreeLinks = 64;
+
+	struct SSmartLink
+	{
+		int entity = InvalidLink;
+		int nextFree = InvalidLink;
+		int generation = 0;
+	};
+
+	inline bool IsValid(SmartId sid) const
+	{
+		if (sid < 0)
+		{
+			return false;
+		}
+
+		int idx = GetSmartIdIndex(sid);
+		return idx < m_smartLinks.size() && m_smartLinks[idx].entity != InvalidLink
+			&& m_smartLinks[idx].generation == GetSmartIdGeneration(sid);
+	}
+
+	// Take the oldest released link, if enough of them are queued, or create the new one
+	inline int AllocateLink()
+	{
+		if (m_numFreeLinks >= MinFreeLinks || (m_numFreeLinks > 0 && m_smartLinks.size() > SmartIdIndexMask))
+		{
+			int idx = m_firstFreeLink;
+			m_firstFreeLink = m_smartLinks[idx].nextFree;
+			if (m_firstFreeLink == InvalidLink)
+			{
+				m_lastFreeLink = InvalidLink;
+			}
+			m_smartLinks[idx].nextFree = InvalidLink;
+			--m_numFreeLinks;
+			return idx;
+		}
+
+		if (m_smartLinks.size() > SmartIdIndexMask || m_smartLinks.size() >= m_smartLinks.max_size())
+		{
+			return InvalidLink;
+		}
+
+		m_smartLinks.emplace_back();
+		return (int)m_smartLinks.size() - 1;
+	}
+
+	// Invalidate the SmartIds of the link and put it in the end of the free queue
+	inline void ReleaseLink(int idx)
+	{
+		SSmartLink& link = m_smartLinks[idx];
+		link.entity = InvalidLink;
+		link.generation = (link.generation + 1) & SmartIdGenerationMask;
+
+		if (m_lastFreeLink != InvalidLink)
+		{
+			m_smartLinks[m_lastFreeLink].nextFree = idx;
+		}
+		else
+		{
+			m_firstFreeLink = idx;
+		}
+		m_lastFreeLink = idx;
+		++m_numFreeLinks;
+	}
+
+	inline void UnlinkEntity(int idx)
 	{
-		m_entities[m_smartLinks[sid]].SetId(InvalidLink);
-		m_smartLinks[sid] = InvalidLink;
+		m_entities[m_smartLinks[idx].entity].SetId(InvalidLink);
+		ReleaseLink(idx);
 	}
 
 	inline void DeleteEntity(int idx)
 	{
-		std::iter_swap(m_entities.begin() + idx, m_entities.end() - 1);
+		std::swap(m_entities[idx], m_entities[m_entities.size() - 1]);
 		if (m_entities[idx].GetId() != InvalidLink)
 		{
-			m_smartLinks[m_entities[idx].GetId()] = idx;
+			m_smartLinks[GetSmartIdIndex(m_entities[idx].GetId())].entity = idx;
 		}
 		m_entities.pop_back();
 	}
 
 protected:
 
-	std::vector<T> m_entities;
-	std::vector<int> m_smartLinks;
+	Storage m_entities;
+	typename SRebindStorage<Storage, SSmartLink>::Type m_smartLinks;
+	int m_firstFreeLink = InvalidLink;
+	int m_lastFreeLink = InvalidLink;
+	int m_numFreeLinks = 0;
 };
\ No newline at end of file
@@ -11,6 +11,7 @@
 #include "ResourceSystem.h"
 #include "UISystem.h"
 #include "SoundSystem.h"
+#include "TaskScheduler.h"
 
 #include <SFML/Window/Event.hpp>
 #include <thread>
@@ -27,6 +28,10 @@ void CGame::Initialize()
 
 	m_pResourceSystem = std::make_unique<CResourceSystem>("Resources");
 	m_pConfigurationSystem = std::make_unique<CConfigurationSystem>("Configuration");
+
+	// The main thread takes part in the tasks too
+	int numWorkers = m_pConfigurationSystem->GetWindowConfiguration().numWorkers;
+	m_pTaskScheduler = std::make_unique<CTaskScheduler>(numWorkers >= 0 ? numWorkers : std::max(0, (int)std::thread::hardware_concurrency() - 1));
 	m_pLogicalSystem = std::make_unique<CLogicalSystem>();
 	m_pPhysicalSystem = std::make_unique<CPhysicalSystem>();
 	m_pRenderSystem = std::make_unique<CRenderSystem>();
@@ -43,6 +48,81 @@ void CGame::Initialize()
 	m_window.setVerticalSyncEnabled(config.bVerticalSynq);
 	m_window.setFramerateLimit(config.frameLitimit);
 	m_window.setActive(false);
+
+	m_tickTime = config.fixedTickRate > 0 ? sf::microseconds(1000000 / config.fixedTickRate) : sf::Time::Zero;
+	m_maxCatchUpTicks = config.maxCatchUpTicks;
+
+	m_bSerialFrame = config.bSerialFrame;
+	BuildFrameGraph();
+
+	m_statisticsPeriod = sf::seconds(config.fStatisticsPeriod);
+	m_pTaskScheduler->ResetStatistics();
+	m_frameGraph.ResetTimes();
+	m_statisticsClock.restart();
+}
+
+void CGame::BuildFrameGraph()
+{
+	int network = m_frameGraph.AddTask("Network", [this]() {
+		if (m_pNetworkSystem->IsServerStarted())
+		{
+			m_pNetworkSystem->AcceptConnections();
+			m_pNetworkSystem->ProcessClientMessages();
+		}
+		else if (m_pNetworkSystem->IsConnected())
+		{
+			m_pNetworkSystem->ProcessServerMessages();
+		}
+	}, true);
+
+	int simulate = m_frameGraph.AddTask("Simulate", [this]() {
+		sf::Time frameTime = m_frameClock.restart();
+		if (!m_bPaused)
+		{
+			Simulate(frameTime);
+		}
+	});
+	m_frameGraph.AddDependency(simulate, network);
+
+	int flush = m_frameGraph.AddTask("FlushTransforms", [this]() {
+		m_pLogicalSystem->FlushTransforms();
+
+		// The render lags behind the simulation for less than a tick to blend the last two ticks
+		float fAlpha = m_tickTime != sf::Time::Zero ? m_tickAccumulator / m_tickTime : 1.f;
+		m_pRenderProxy->OnCommand<RenderCommand::SetInterpolationCommand>(InvalidLink, fAlpha);
+	});
+	m_frameGraph.AddDependency(flush, simulate);
+
+	// The bullets are rendered straight into the sprite batches, so they don't wait for the render commands
+	int bullets = m_frameGraph.AddTask("RenderBullets", [this]() {
+		float fAlpha = m_tickTime != sf::Time::Zero ? m_tickAccumulator / m_tickTime : 1.f;
+		m_pLogicalSystem->Render((1.f - fAlpha) * m_tickTime.asSeconds());
+	});
+	m_frameGraph.AddDependency(bullets, simulate);
+
+	int logicalGarbage = m_frameGraph.AddTask("LogicalGarbage", [this]() { m_pLogicalSystem->CollectGarbage(); });
+	m_frameGraph.AddDependency(logicalGarbage, flush);
+
+	// The UI actions could load the level, so the UI runs on the main thread once the logical stages are done
+	int ui = m_frameGraph.AddTask("UI", [this]() { m_pUISystem->Update(); }, true);
+	m_frameGraph.AddDependency(ui, logicalGarbage);
+	m_frameGraph.AddDependency(ui, bullets);
+
+	// The removed logical entities release their physical entities
+	int physicalGarbage = m_frameGraph.AddTask("PhysicalGarbage", [this]() { m_pPhysicalSystem->CollectGarbage(); });
+	m_frameGraph.AddDependency(physicalGarbage, ui);
+
+	int sound = m_frameGraph.AddTask("Sound", [this]() { m_pSoundSystem->Update(); });
+	m_frameGraph.AddDependency(sound, ui);
+
+	// The state is serialized after the UI actions, the same as it was before the frame graph
+	int serialize = m_frameGraph.AddTask("Serialize", [this]() {
+		if (m_pNetworkSystem->IsServerStarted())
+		{
+			m_pNetworkProxy->Serialize();
+		}
+	});
+	m_frameGraph.AddDependency(serialize, ui);
 }
 
 void CGame::Release()
@@ -54,6 +134,7 @@ void CGame::Release()
 	m_pNetworkSystem.reset();
 	m_pConfigurationSystem.reset();
 	m_pResourceSystem.reset();
+	m_pTaskScheduler.reset();
 }
 
 void CGame::ProcessEvents()
@@ -85,42 +166,16 @@ void CGame::Start()
 
 	std::thread render(StartRender);
 
-	sf::Clock frameClock;
+	m_frameClock.restart();
 
 	while (m_window.isOpen())
 	{
 		ProcessEvents();
 
-		if (m_pNetworkSystem->IsServerStarted())
-		{
-			m_pNetworkSystem->AcceptConnections();
-			m_pNetworkSystem->ProcessClientMessages();
-		}
-		else if (m_pNetworkSystem->IsConnected())
-		{
-			m_pNetworkSystem->ProcessServerMessages();
-		}
-
-		if (!m_bPaused)
-		{
-			m_pPhysicalSystem->ProcessCollisions();
-			m_pLogicalSystem->Update(frameClock.getElapsedTime());
-		}
+		m_frameGraph.Run(*m_pTaskScheduler, m_bSerialFrame);
 
-		frameClock.restart();
+		LogStatistics();
 
-		m_pLogicalSystem->CollectGarbage();
-		m_pPhysicalSystem->CollectGarbage();
-
-		m_pSoundSystem->Update();
-
-		m_pUISystem->Update();
-
-		if (m_pNetworkSystem->IsServerStarted())
-		{
-			m_pNetworkProxy->Serialize();
-		}
-		
 		{
 			std::unique_lock<std::mutex> lock(m_renderLock);
 			m_renderSync.wait(lock, [this]() { return m_bRenderComplete; });
@@ -130,6 +185,7 @@ void CGame::Start()
 			m_pRenderSystem->CollectGarbage();
 			m_pRenderSystem->FixNumActiveEntities();
 			m_pRenderProxy->SwitchStreams();
+			m_pRenderSystem->SwitchBatches();
 
 			m_bMainComplete = true;
 		}
@@ -141,6 +197,73 @@ void CGame::Start()
 	render.join();
 }
 
+void CGame::Simulate(sf::Time frameTime)
+{
+	if (m_tickTime == sf::Time::Zero)
+	{
+		m_pRenderProxy->OnCommand<RenderCommand::NextTickCommand>(InvalidLink);
+		m_pPhysicalSystem->ProcessCollisions();
+		m_pLogicalSystem->Update(frameTime);
+		return;
+	}
+
+	m_tickAccumulator += frameTime;
+
+	int numTicks = 0;
+	while (m_tickAccumulator >= m_tickTime && numTicks < m_maxCatchUpTicks)
+	{
+		// The collisions of the next tick need the transforms changed by the bullet hits of the previous one
+		if (numTicks > 0)
+		{
+			m_pLogicalSystem->FlushTransforms();
+		}
+
+		m_pRenderProxy->OnCommand<RenderCommand::NextTickCommand>(InvalidLink);
+		m_pPhysicalSystem->ProcessCollisions();
+		m_pLogicalSystem->Update(m_tickTime);
+
+		m_tickAccumulator -= m_tickTime;
+		++numTicks;
+	}
+
+	// The simulation slows down instead of spiraling after the long frames
+	if (m_tickAccumulator >= m_tickTime)
+	{
+		m_tickAccumulator = sf::microseconds(m_tickAccumulator.asMicroseconds() % m_tickTime.asMicroseconds());
+	}
+}
+
+void CGame::LogStatistics()
+{
+	if (m_statisticsPeriod == sf::Time::Zero || m_statisticsClock.getElapsedTime() < m_statisticsPeriod)
+	{
+		return;
+	}
+	m_statisticsClock.restart();
+
+	for (int thread = 0; thread < m_pTaskScheduler->GetNumThreads(); ++thread)
+	{
+		CTaskScheduler::SStatistics statistics = m_pTaskScheduler->GetStatistics(thread);
+		Log("Thread ", thread, ": utilization ", (int)(statistics.fUtilization * 100.f), "%, tasks ", statistics.numTasks, ", steals ", statistics.numSteals);
+	}
+	m_pTaskScheduler->ResetStatistics();
+
+	// The average times per frame, the serial frame's ones are the single-threaded baseline
+	int numRuns = std::max(1, m_frameGraph.GetNumRuns());
+	Log(m_bSerialFrame ? "Serial" : "Parallel", " frame: ", m_frameGraph.GetRunTime().asMicroseconds() / numRuns, " us");
+	for (int task = 0; task < m_frameGraph.GetNumTasks(); ++task)
+	{
+		Log("  ", m_frameGraph.GetTaskName(task), ": ", m_frameGraph.GetTaskTime(task).asMicroseconds() / numRuns, " us");
+	}
+	m_frameGraph.ResetTimes();
+
+	const CPhysicalSystem::SStatistics& physics = m_pPhysicalSystem->GetStatistics();
+	Log("Physics: candidates ", physics.numCandidates, ", rejected ", physics.numRejected, ", collisions ", physics.numCollisions, ", time ", physics.time.asMicroseconds(), " us");
+
+	const CLogicalSystem::SStatistics& logic = m_pLogicalSystem->GetStatistics();
+	Log("Logic: flushes ", logic.numFlushes, ", coalesced updates ", logic.numCoalescedUpdates, ", pool hits ", logic.numPoolHits, ", pool misses ", logic.numPoolMisses, ", expired timers ", logic.numExpiredTimers);
+}
+
 void CGame::StartRender()
 {
 	CGame& game = CGame::Get();
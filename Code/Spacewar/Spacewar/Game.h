@@ -8,6 +8,9 @@
 
 #include <SFML/Graphics/RenderWindow.hpp>
 #include <SFML/Graphics/View.hpp>
+#include <SFML/System/Clock.hpp>
+
+#include "TaskGraph.h"
 
 /**
  * @interface IWindowEventListener
@@ -33,6 +36,7 @@ class CUISystem;
 class CNetworkSystem;
 class CNetworkProxy;
 class CSoundSystem;
+class CTaskScheduler;
 
 /**
  * @class CGame
@@ -89,6 +93,7 @@ public:
 	CNetworkSystem* GetNetworkSystem() { return m_pNetworkSystem.get(); }
 	CNetworkProxy* GetNetworkProxy() { return m_pNetworkProxy.get(); }
 	CSoundSystem* GetSoundSystem() { return m_pSoundSystem.get(); }
+	CTaskScheduler* GetTaskScheduler() { return m_pTaskScheduler.get(); }
 
 	void RegisterWindowEventListener(const std::weak_ptr<IWindowEventListener>& pEventListener);
 	void ResetView(float fSize);
@@ -107,6 +112,35 @@ private:
 
 	// Process the game window evetns and send them to event listeners
 	void ProcessEvents();
+
+	/**
+	 * @function BuildFrameGraph
+	 * Build the graph of the frame's stages. The stages without the ordering
+	 * constraints between them are run in parallel. The stages using the window
+	 * or the network (they could load the level too) are run on the main thread.
+	 */
+	void BuildFrameGraph();
+
+	/**
+	 * @function Simulate
+	 * Step the physics and the logic. In the fixed tick mode the frame time
+	 * is accumulated and the simulation is stepped with the fixed tick as many
+	 * times as the accumulated time allows, but not more than the configured
+	 * number of the catch-up ticks. Otherwise the simulation is stepped once
+	 * with the frame time.
+	 *
+	 * @param frameTime - time passed since the last frame.
+	 */
+	void Simulate(sf::Time frameTime);
+
+	/**
+	 * @function LogStatistics
+	 * Log the utilization of the task scheduler's threads, the average times
+	 * of the frame's stages and the statistics of the last simulation once per
+	 * the configured period. The scheduler's counters and the stages' times
+	 * are reset after that, so each log covers one period.
+	 */
+	void LogStatistics();
 	
 	/**
 	 * @function StartRender
@@ -130,6 +164,7 @@ private:
 	std::unique_ptr<CNetworkSystem> m_pNetworkSystem;
 	std::unique_ptr<CNetworkProxy> m_pNetworkProxy;
 	std::unique_ptr<CSoundSystem> m_pSoundSystem;
+	std::unique_ptr<CTaskScheduler> m_pTaskScheduler;
 
 	std::mutex m_renderLock;
 	std::condition_variable m_renderSync;
@@ -140,6 +175,17 @@ private:
 
 	std::list<std::weak_ptr<IWindowEventListener>> m_windowEventListeners;
 
+	CTaskGraph m_frameGraph;
+	bool m_bSerialFrame = false;
+	sf::Clock m_frameClock;
+
+	sf::Time m_tickTime; // zero if the tick isn't fixed
+	sf::Time m_tickAccumulator;
+	int m_maxCatchUpTicks = 1;
+
+	sf::Time m_statisticsPeriod; // zero if the statistics aren't logged
+	sf::Clock m_statisticsClock;
+
 	bool m_bPaused = false;
 	bool m_bServer = true;
 };
\ No newline at end of file
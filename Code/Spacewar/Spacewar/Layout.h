@@ -420,7 +420,7 @@ private:
 		if (!id.empty())
 		{
 			CRenderSystem* pRenderSystem = CGame::Get().GetRenderSystem();
-			SmartId sid = pRenderSystem->CreateEntity(CRenderEntity::Text);
+			SmartId sid = pRenderSystem->CreateEntity(CRenderEntity::Text, CRenderEntity::UI);
 			if (CRenderEntity* pEntity = pRenderSystem->GetEntity(sid))
 			{
 				std::string value = node.attribute("value").value();
@@ -479,7 +479,7 @@ private:
 			int textureId = CGame::Get().GetResourceSystem()->GetTextureId(node.attribute("value").value());
 			if (textureId != -1)
 			{
-				SmartId sid = CGame::Get().GetRenderSystem()->CreateEntity(CRenderEntity::Sprite);
+				SmartId sid = CGame::Get().GetRenderSystem()->CreateEntity(CRenderEntity::Sprite, CRenderEntity::UI);
 
 				CRenderProxy* pRenderProxy = CGame::Get().GetRenderProxy();
 				pRenderProxy->OnCommand<RenderCommand::SetTextureCommand>(sid, textureId);
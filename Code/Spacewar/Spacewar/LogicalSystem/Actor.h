@@ -13,7 +13,6 @@ enum EActorType : uint8_t
 {
 	EActorType_Player,
 	EActorType_Hole,
-	EActorType_Projectile,
 	EActorType_Bonus
 };
 
@@ -33,12 +32,20 @@ public:
 	SmartId GetEntityId() const { return m_entityId; }
 
 	/**
-	 * @function OnCollision
-	 * Inherited from the IPhysicalEventListener function to handle the entities collision.
+	 * @function OnCollisionBegin
+	 * Inherited from the IPhysicalEventListener function to handle the beginning of the entities collision.
 	 * 
 	 * @param sid = SmartId of the logical entity id, which the actor collided with.
 	 */
-	virtual void OnCollision(SmartId sid) override {}
+	virtual void OnCollisionBegin(SmartId sid) override {}
+
+	/**
+	 * @function OnBulletHit
+	 * Handle the hit of the bullet (see CBulletSystem).
+	 * 
+	 * @param ownerId - SmartId of the logical entity which shot the bullet.
+	 */
+	virtual void OnBulletHit(SmartId ownerId) {}
 
 	virtual EActorType GetType() const = 0;
 	virtual void Update(sf::Time dt) = 0;
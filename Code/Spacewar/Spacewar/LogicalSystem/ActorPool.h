@@ -0,0 +1,160 @@
+#pragma once
+
+#include <new>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <cstdint>
+
+/**
+ * @class CActorPool
+ * Pool of the actors of the same type. The actors are constructed in-place
+ * in the fixed size segments, so they are stored contiguously and never move:
+ * the actors are registered as the listeners by pointers in the other systems.
+ * The slots of the destroyed actors are reused by the new ones.
+ *
+ * @template param T - type of the actors.
+ * @template param SegmentSize - number of the actors in a segment.
+ */
+template <typename T, int SegmentSize = 64>
+class CActorPool
+{
+	struct SSegment
+	{
+		alignas(T) unsigned char data[sizeof(T) * SegmentSize];
+	};
+
+public:
+
+	// The creations which reused the slots of the destroyed actors and the ones which needed the new slots
+	struct SStatistics
+	{
+		int numHits = 0;
+		int numMisses = 0;
+	};
+
+public:
+
+	CActorPool() = default;
+	CActorPool(const CActorPool&) = delete;
+	CActorPool& operator=(const CActorPool&) = delete;
+
+	~CActorPool()
+	{
+		Clear();
+	}
+
+	/**
+	 * @function Create
+	 * Construct an actor in a free slot.
+	 *
+	 * @params args - params to be passed into the actor's contructor.
+	 * @return index of the actor's slot.
+	 */
+	template <typename... V>
+	int Create(V&&... args)
+	{
+		int slot;
+		if (!m_freeSlots.empty())
+		{
+			slot = m_freeSlots.back();
+			m_freeSlots.pop_back();
+			++m_statistics.numHits;
+		}
+		else
+		{
+			slot = (int)m_alive.size();
+			if (slot % SegmentSize == 0)
+			{
+				m_segments.push_back(std::make_unique<SSegment>());
+			}
+			m_alive.push_back(0);
+			++m_statistics.numMisses;
+		}
+
+		// The slot is marked alive after the construction, so it's not visited
+		// by the iterations started from the actor's constructor
+		new (GetSlot(slot)) T(std::forward<V>(args)...);
+		m_alive[slot] = 1;
+		++m_dNumAlive;
+
+		return slot;
+	}
+
+	void Destroy(int slot)
+	{
+		if (slot >= 0 && slot < (int)m_alive.size() && m_alive[slot])
+		{
+			// The slot is released before the destruction for the same reason
+			m_alive[slot] = 0;
+			--m_dNumAlive;
+			GetSlot(slot)->~T();
+			m_freeSlots.push_back(slot);
+		}
+	}
+
+	void Clear()
+	{
+		for (int slot = 0; slot < (int)m_alive.size(); ++slot)
+		{
+			Destroy(slot);
+		}
+	}
+
+	T* Get(int slot)
+	{
+		return slot >= 0 && slot < (int)m_alive.size() && m_alive[slot] ? GetSlot(slot) : nullptr;
+	}
+
+	int GetNumAlive() const { return m_dNumAlive; }
+	const SStatistics& GetStatistics() const { return m_statistics; }
+
+	/**
+	 * @function ForEach
+	 * Iterate over the alive actors in the order of their slots.
+	 * The actors created during the iteration could be visited too.
+	 *
+	 * @param f - function which the actors is applied to. The iteration stops if it returns false.
+	 * @return False if the iteration was stopped.
+	 */
+	template <typename F>
+	bool ForEach(F&& f)
+	{
+		for (int slot = 0; slot < (int)m_alive.size(); ++slot)
+		{
+			if (m_alive[slot] && !f(*GetSlot(slot)))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	template <typename F>
+	bool ForEach(F&& f) const
+	{
+		for (int slot = 0; slot < (int)m_alive.size(); ++slot)
+		{
+			if (m_alive[slot] && !f(static_cast<const T&>(*GetSlot(slot))))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+private:
+
+	T* GetSlot(int slot) const
+	{
+		return reinterpret_cast<T*>(m_segments[slot / SegmentSize]->data) + slot % SegmentSize;
+	}
+
+private:
+
+	std::vector<std::unique_ptr<SSegment>> m_segments;
+	std::vector<uint8_t> m_alive;
+	std::vector<int> m_freeSlots;
+	int m_dNumAlive = 0;
+	SStatistics m_statistics;
+};
\ No newline at end of file
@@ -1,105 +1,116 @@
 #include "StdAfx.h"
 #include "ActorSystem.h"
 
-void CActorSystem::RemoveActor(SmartId sid, bool immediate)
+const CActorSystem::SActorSlot* CActorSystem::FindSlot(SmartId sid) const
 {
-	bool exist = m_actors.find(sid) != m_actors.end();
-	exist &= std::find(m_removeDeferred.begin(), m_removeDeferred.end(), sid) == m_removeDeferred.end();
-	if (exist)
+	int idx = GetSmartIdIndex(sid);
+	if (sid >= 0 && idx < m_actorSlots.size() && m_actorSlots[idx].sid == sid)
 	{
-		if (immediate)
-		{
-			m_actors.erase(sid);
-		}
-		else
-		{
-			m_removeDeferred.push_back(sid);
-		}
-		CGame::Get().GetNetworkProxy()->BroadcastServerMessage<ServerMessage::SRemoveActorMessage>(sid);
+		return &m_actorSlots[idx];
 	}
+	return nullptr;
 }
 
-CActor* CActorSystem::GetActor(SmartId sid)
+void CActorSystem::DestroyActor(const SActorSlot& actorSlot)
 {
-	auto fnd = m_actors.find(sid);
-	return fnd != m_actors.end() ? fnd->second.get() : nullptr;
+	int slot = actorSlot.slot;
+	EActorType type = actorSlot.type;
+
+	// The slot is released before the actor's destructor, which could create or remove the other actors
+	m_actorSlots[GetSmartIdIndex(actorSlot.sid)] = SActorSlot();
+
+	switch (type)
+	{
+	case EActorType_Player:
+		GetPool<CPlayer>().Destroy(slot);
+		break;
+	case EActorType_Hole:
+		GetPool<CHole>().Destroy(slot);
+		break;
+	case EActorType_Bonus:
+		GetPool<CBonus>().Destroy(slot);
+		break;
+	}
 }
 
-void CActorSystem::ForEachPlayer(std::function<bool(CPlayer*)> f)
+void CActorSystem::RemoveActor(SmartId sid, bool immediate)
 {
-	for (const auto& [sid, pActor] : m_actors)
+	const SActorSlot* pActorSlot = FindSlot(sid);
+	if (pActorSlot && std::find(m_removeDeferred.begin(), m_removeDeferred.end(), sid) == m_removeDeferred.end())
 	{
-		if (pActor->GetType() == EActorType_Player)
+		if (immediate)
 		{
-			if (!f(static_cast<CPlayer*>(pActor.get())))
-			{
-				break;
-			}
+			DestroyActor(*pActorSlot);
 		}
+		else
+		{
+			m_removeDeferred.push_back(sid);
+		}
+		CGame::Get().GetNetworkProxy()->BroadcastServerMessage<ServerMessage::SRemoveActorMessage>(sid);
 	}
 }
 
-void CActorSystem::RemoveProjectiles()
+CActor* CActorSystem::GetActor(SmartId sid)
 {
-	for (const auto& [sid, pActor] : m_actors)
+	if (const SActorSlot* pActorSlot = FindSlot(sid))
 	{
-		if (pActor->GetType() == EActorType_Projectile)
+		switch (pActorSlot->type)
 		{
-			RemoveActor(pActor->GetEntityId());
+		case EActorType_Player:
+			return GetPool<CPlayer>().Get(pActorSlot->slot);
+		case EActorType_Hole:
+			return GetPool<CHole>().Get(pActorSlot->slot);
+		case EActorType_Bonus:
+			return GetPool<CBonus>().Get(pActorSlot->slot);
 		}
 	}
+	return nullptr;
 }
 
 int CActorSystem::GetNumPlayers() const
 {
-	int count = 0;
-	for (const auto& [sid, pActor] : m_actors)
-	{
-		if (pActor->GetType() == EActorType_Player)
-		{
-			++count;
-		}
-	}
-	return count;
+	return GetPool<CPlayer>().GetNumAlive();
 }
 
 SmartId CActorSystem::GetFirstPlayerId() const
 {
-	for (auto iter = m_actors.begin(); iter != m_actors.end(); ++iter)
-	{
-		if (iter->second->GetType() == EActorType_Player)
+	// The players are ordered by the SmartIds of their entities
+	SmartId first = InvalidLink;
+	GetPool<CPlayer>().ForEach([&first](const CPlayer& player)
 		{
-			return iter->first;
-		}
-	}
-	return InvalidLink;
+			if (first == InvalidLink || player.GetEntityId() < first)
+			{
+				first = player.GetEntityId();
+			}
+			return true;
+		});
+	return first;
 }
 
 SmartId CActorSystem::GetLastPlayerId() const
 {
-	for (auto iter = m_actors.rbegin(); iter != m_actors.rend(); ++iter)
-	{
-		if (iter->second->GetType() == EActorType_Player)
+	SmartId last = InvalidLink;
+	GetPool<CPlayer>().ForEach([&last](const CPlayer& player)
 		{
-			return iter->first;
-		}
-	}
-	return InvalidLink;
+			last = std::max(last, player.GetEntityId());
+			return true;
+		});
+	return last;
 }
 
 void CActorSystem::Update(sf::Time dt)
 {
-	for (const auto& [sid, pActor] : m_actors)
-	{
-		pActor->Update(dt);
-	}
+	ForEachActor([dt](CActor& actor) { actor.Update(dt); });
 }
 
 void CActorSystem::CollectGarbage()
 {
 	for (SmartId sid : m_removeDeferred)
 	{
-		m_actors.erase(sid);
+		if (const SActorSlot* pActorSlot = FindSlot(sid))
+		{
+			DestroyActor(*pActorSlot);
+		}
 	}
 	m_removeDeferred.clear();
 }
@@ -107,27 +118,28 @@ void CActorSystem::CollectGarbage()
 void CActorSystem::Release()
 {
 	m_removeDeferred.clear();
-	m_actors.clear();
+	std::apply([](auto&... pools) { (pools.Clear(), ...); }, m_pools);
+	m_actorSlots.clear();
 }
 
 void CActorSystem::Serialize(sf::Packet& packet, bool bReading)
 {
 	if (!bReading)
 	{
-		for (auto& [sid, pActor] : m_actors)
-		{
-			if (pActor->NeedSerialize())
+		ForEachActor([&packet](CActor& actor)
 			{
-				packet << sid;
-				
-				uint16_t size = 0;
-				pActor->Serialize(packet, ESerializationMode_Count, size);
-				packet << size;
+				if (actor.NeedSerialize())
+				{
+					packet << actor.GetEntityId();
 
-				size = 0;
-				pActor->Serialize(packet, ESerializationMode_Write, size);
-			}
-		}
+					uint16_t size = 0;
+					actor.Serialize(packet, ESerializationMode_Count, size);
+					packet << size;
+
+					size = 0;
+					actor.Serialize(packet, ESerializationMode_Write, size);
+				}
+			});
 	}
 	else
 	{
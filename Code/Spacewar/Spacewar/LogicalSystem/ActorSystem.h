@@ -1,13 +1,13 @@
 #pragma once
 
 #include "Hole.h"
-#include "Projectile.h"
 #include "Bonus.h"
 #include "Player.h"
 #include "Game.h"
 #include "NetworkSystem/NetworkProxy.h"
+#include "ActorPool.h"
 
-#include <map>
+#include <tuple>
 #include <vector>
 #include <memory>
 #include <functional>
@@ -22,6 +22,9 @@ struct is_player<CPlayer> : std::true_type {};
 /**
  * @class CActorSystem
  * System containing actors. Provides the interface for creating, deleting and processing actors.
+ * The actors of each type are stored in their own pool (see CActorPool), so processing
+ * the actors of a type walks the contiguous memory. The actors are found by the SmartIds
+ * of their entities via the flat index of the pools' slots.
  */
 class CActorSystem
 {
@@ -41,19 +44,31 @@ public:
 	template<typename T, typename... V>
 	SmartId CreateActor(V&&... args)
 	{
-		std::unique_ptr<CActor> pActor = std::make_unique<T>(std::forward<V>(args)...);
+		CActorPool<T>& pool = GetPool<T>();
+		int slot = pool.Create(std::forward<V>(args)...);
+		T* pActor = pool.Get(slot);
+
 		SmartId sid = pActor->GetEntityId();
 		if (sid != InvalidLink)
 		{
-			m_actors[sid] = std::move(pActor);
+			int idx = GetSmartIdIndex(sid);
+			if (idx >= m_actorSlots.size())
+			{
+				m_actorSlots.resize(idx + 1);
+			}
+			m_actorSlots[idx] = SActorSlot{ sid, pActor->GetType(), slot };
 
-			CGame::Get().GetNetworkProxy()->SendCreateActor(sid, m_actors[sid]->GetType(), std::forward<V>(args)...);
+			CGame::Get().GetNetworkProxy()->SendCreateActor(sid, pActor->GetType(), std::forward<V>(args)...);
 
 			if constexpr (is_player<T>::value)
 			{
-				static_cast<CPlayer*>(m_actors[sid].get())->SetShooting(m_bPlayersShooting);
+				pActor->SetShooting(m_bPlayersShooting);
 			}
 		}
+		else
+		{
+			pool.Destroy(slot);
+		}
 
 		return sid;
 	}
@@ -75,8 +90,6 @@ public:
 			return CreateActor<CHole>(std::forward<V>(args)...);
 		case EActorType_Bonus:
 			return CreateActor<CBonus>(std::forward<V>(args)...);
-		case EActorType_Projectile:
-			return CreateActor<CProjectile>(std::forward<V>(args)...);
 		}
 		return InvalidLink;
 	}
@@ -99,14 +112,33 @@ public:
 	 * @function ForEachPlayer
 	 * Iterate over all the players in the system.
 	 * 
-	 * @param f - function which the actors is applied to.
+	 * @param f - function which the actors is applied to. The iteration stops if it returns false.
 	 */
-	void ForEachPlayer(std::function<bool(CPlayer*)> f);
+	template <typename F>
+	void ForEachPlayer(F&& f)
+	{
+		GetPool<CPlayer>().ForEach([&f](CPlayer& player) { return f(&player); });
+	}
+
+	/**
+	 * @function ForEachHole
+	 * Iterate over all the holes in the system.
+	 * 
+	 * @param f - function which the actors is applied to. The iteration stops if it returns false.
+	 */
+	template <typename F>
+	void ForEachHole(F&& f)
+	{
+		GetPool<CHole>().ForEach([&f](CHole& hole) { return f(&hole); });
+	}
+
 	int GetNumPlayers() const;
 	SmartId GetFirstPlayerId() const;
 	SmartId GetLastPlayerId() const;
 
-	void RemoveProjectiles();
+	// Slot reuse statistics of the pool of the actors of the type T
+	template <typename T>
+	const typename CActorPool<T>::SStatistics& GetPoolStatistics() const { return GetPool<T>().GetStatistics(); }
 
 	/**
 	 * @function Update
@@ -141,8 +173,34 @@ public:
 	void Serialize(sf::Packet& packet, bool bReading);
 
 private:
-	
-	std::map<SmartId, std::unique_ptr<CActor>> m_actors;
+
+	struct SActorSlot
+	{
+		SmartId sid = InvalidLink;
+		EActorType type = EActorType_Player;
+		int slot = InvalidLink;
+	};
+
+	template <typename T>
+	CActorPool<T>& GetPool() { return std::get<CActorPool<T>>(m_pools); }
+
+	template <typename T>
+	const CActorPool<T>& GetPool() const { return std::get<CActorPool<T>>(m_pools); }
+
+	// Apply the function to all the actors of all the types
+	template <typename F>
+	void ForEachActor(F&& f)
+	{
+		std::apply([&f](auto&... pools) { (pools.ForEach([&f](CActor& actor) { f(actor); return true; }), ...); }, m_pools);
+	}
+
+	const SActorSlot* FindSlot(SmartId sid) const;
+	void DestroyActor(const SActorSlot& actorSlot);
+
+private:
+
+	std::tuple<CActorPool<CPlayer>, CActorPool<CHole>, CActorPool<CBonus>> m_pools;
+	std::vector<SActorSlot> m_actorSlots;
 	std::vector<SmartId> m_removeDeferred;
 
 	bool m_bPlayersShooting = false;
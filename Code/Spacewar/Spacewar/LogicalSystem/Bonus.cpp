@@ -7,6 +7,11 @@
 
 CBonus::CBonus(const std::string& entity) : CActor(entity) {}
 
+CBonus::~CBonus()
+{
+	CGame::Get().GetLogicalSystem()->GetTimers()->Cancel(m_lifetimeTimer);
+}
+
 void CBonus::SetBonus(EBonusType type, float fVal)
 {
 	m_type = type;
@@ -15,10 +20,12 @@ void CBonus::SetBonus(EBonusType type, float fVal)
 
 void CBonus::SetLifetime(float fLifetime)
 {
-	m_fLifetime = fLifetime;
+	CTimerWheel* pTimers = CGame::Get().GetLogicalSystem()->GetTimers();
+	pTimers->Cancel(m_lifetimeTimer);
+	m_lifetimeTimer = pTimers->Schedule(fLifetime, this);
 }
 
-void CBonus::OnCollision(SmartId sid)
+void CBonus::OnCollisionBegin(SmartId sid)
 {
 	if (CActor* pActor = CGame::Get().GetLogicalSystem()->GetActorSystem()->GetActor(sid))
 	{
@@ -40,11 +47,7 @@ void CBonus::OnCollision(SmartId sid)
 	}
 }
 
-void CBonus::Update(sf::Time dt)
+void CBonus::OnTimer(int tag)
 {
-	m_fLifetime -= dt.asSeconds();
-	if (m_fLifetime < 0.f)
-	{
-		Destroy();
-	}
+	Destroy();
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Actor.h"
+#include "TimerWheel.h"
 
 /**
  * @class CBonus
@@ -8,7 +9,7 @@
  * player gets some additional abstract points (fuel, ammo, etc).
  * This class describes all the bonuses' logic.
  */
-class CBonus : public CActor
+class CBonus final : public CActor, public ITimerListener
 {
 public:
 
@@ -20,10 +21,14 @@ public:
 	};
 
 	CBonus(const std::string& entity);
+	~CBonus();
 
-	virtual void OnCollision(SmartId sid) override;
+	virtual void OnCollisionBegin(SmartId sid) override;
 	virtual EActorType GetType() const override { return EActorType_Bonus; }
-	virtual void Update(sf::Time dt) override;
+	virtual void Update(sf::Time dt) override {}
+
+	// The bonus is destroyed on the lifetime's expiration
+	virtual void OnTimer(int tag) override;
 
 	void SetBonus(EBonusType type, float fVal);
 	void SetLifetime(float fLifetime);
@@ -32,5 +37,5 @@ private:
 
 	EBonusType m_type = None;
 	float m_fVal = 0.f;
-	float m_fLifetime = 0.f;
+	SmartId m_lifetimeTimer = InvalidLink;
 };
\ No newline at end of file
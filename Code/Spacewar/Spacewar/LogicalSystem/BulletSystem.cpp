@@ -0,0 +1,475 @@
+#include "StdAfx.h"
+#include "BulletSystem.h"
+#include "SegmentDistance.h"
+#include "Game.h"
+#include "LogicalSystem.h"
+#include "ActorSystem.h"
+#include "LevelSystem.h"
+#include "ResourceSystem.h"
+#include "ConfigurationSystem/ConfigurationSystem.h"
+#include "ConfigurationSystem/EntityConfiguration.h"
+#include "PhysicalSystem/PhysicalSystem.h"
+#include "RenderSystem/RenderSystem.h"
+#include "NetworkSystem/NetworkProxy.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+
+// The bullets are gathered into the clusters of this size, the targets are searched around each cluster
+static constexpr float ClusterSize = 250.f;
+static constexpr int InitialNumTargets = 256;
+
+int CBulletSystem::FindClass(const std::string& name)
+{
+	for (int i = 0; i < m_classes.size(); ++i)
+	{
+		if (m_classes[i].name == name)
+		{
+			return i;
+		}
+	}
+
+	const CEntityConfiguration::SEntityClass* pEntityClass = CGame::Get().GetConfigurationSystem()->GetEntityConfiguration()->GetEntityClass(name);
+	if (!pEntityClass)
+	{
+		Log("Failed to find entity class ", name);
+		return InvalidLink;
+	}
+
+	SBulletClass bulletClass;
+	bulletClass.name = name;
+	bulletClass.filter = pEntityClass->collisionFilter;
+	bulletClass.bGravity = pEntityClass->bGravity;
+
+	switch (pEntityClass->physicsType)
+	{
+	case PhysicalPrimitive::EPrimitiveType_Circle:
+		bulletClass.fRad = static_cast<const CEntityConfiguration::CircleConfig*>(pEntityClass->pPhysics.get())->fRad;
+		break;
+	case PhysicalPrimitive::EPrimitiveType_Capsule:
+		if (const auto* pCapsuleConfig = static_cast<const CEntityConfiguration::CapsuleConfig*>(pEntityClass->pPhysics.get()))
+		{
+			bulletClass.vHalfAxis = pCapsuleConfig->fHalfHeight * pCapsuleConfig->vAxis;
+			bulletClass.fRad = pCapsuleConfig->fRad;
+		}
+		break;
+	default:
+		Log("Bullet entity class ", name, " should have the round physics");
+		return InvalidLink;
+	}
+
+	if (!pEntityClass->renderSlots.empty())
+	{
+		bulletClass.textureId = pEntityClass->renderSlots[0].textureId;
+		bulletClass.vSize = pEntityClass->renderSlots[0].vSize;
+		if (const sf::Image* pImage = CGame::Get().GetResourceSystem()->GetTexture(bulletClass.textureId))
+		{
+			bulletClass.vTextureSize = sf::Vector2f(pImage->getSize());
+			if (bulletClass.vSize == sf::Vector2f())
+			{
+				bulletClass.vSize = bulletClass.vTextureSize;
+			}
+		}
+	}
+
+	m_classes.push_back(std::move(bulletClass));
+	return (int)m_classes.size() - 1;
+}
+
+void CBulletSystem::Spawn(const std::string& entityClass, SmartId ownerId, const sf::Vector2f& vPos, float fRot, const sf::Vector2f& vVel, float fLifetime)
+{
+	int classIdx = FindClass(entityClass);
+	if (classIdx == InvalidLink)
+	{
+		return;
+	}
+
+	float fAngle = fRot * 3.141592654f / 180.f;
+
+	m_posX.push_back(vPos.x);
+	m_posY.push_back(vPos.y);
+	m_velX.push_back(vVel.x);
+	m_velY.push_back(vVel.y);
+	m_cos.push_back(cosf(fAngle));
+	m_sin.push_back(sinf(fAngle));
+	m_lifetime.push_back(fLifetime);
+	m_axisAX.push_back(vPos.x);
+	m_axisAY.push_back(vPos.y);
+	m_axisBX.push_back(vPos.x);
+	m_axisBY.push_back(vPos.y);
+	m_rad.push_back(m_classes[classIdx].fRad);
+	m_gravity.push_back(m_classes[classIdx].bGravity ? 1.f : 0.f);
+	m_class.push_back(classIdx);
+	m_owners.push_back(ownerId);
+	m_hitTargets.push_back(InvalidLink);
+
+	CGame::Get().GetNetworkProxy()->SendSpawnBullet(entityClass, ownerId, vPos, fRot, vVel, fLifetime);
+}
+
+void CBulletSystem::RemoveBullet(int idx)
+{
+	auto removeAt = [idx](auto& v)
+	{
+		v[idx] = v.back();
+		v.pop_back();
+	};
+
+	removeAt(m_posX);
+	removeAt(m_posY);
+	removeAt(m_velX);
+	removeAt(m_velY);
+	removeAt(m_cos);
+	removeAt(m_sin);
+	removeAt(m_lifetime);
+	removeAt(m_axisAX);
+	removeAt(m_axisAY);
+	removeAt(m_axisBX);
+	removeAt(m_axisBY);
+	removeAt(m_rad);
+	removeAt(m_gravity);
+	removeAt(m_class);
+	removeAt(m_owners);
+	removeAt(m_hitTargets);
+}
+
+void CBulletSystem::RemoveBullets()
+{
+	Clear();
+	if (CGame::Get().IsServer())
+	{
+		CGame::Get().GetNetworkProxy()->BroadcastServerMessage<ServerMessage::SRemoveBulletsMessage>();
+	}
+}
+
+void CBulletSystem::Clear()
+{
+	m_posX.clear();
+	m_posY.clear();
+	m_velX.clear();
+	m_velY.clear();
+	m_cos.clear();
+	m_sin.clear();
+	m_lifetime.clear();
+	m_axisAX.clear();
+	m_axisAY.clear();
+	m_axisBX.clear();
+	m_axisBY.clear();
+	m_rad.clear();
+	m_gravity.clear();
+	m_class.clear();
+	m_owners.clear();
+	m_hitTargets.clear();
+}
+
+void CBulletSystem::ApplyGravity(const CGravity& gravity, float dt)
+{
+	const int num = GetNumBullets();
+	if (num == 0 || gravity.GetNumSources() == 0)
+	{
+		return;
+	}
+
+	m_prevVelX = m_velX;
+	m_prevVelY = m_velY;
+
+	gravity.Apply(m_posX.data(), m_posY.data(), m_velX.data(), m_velY.data(), m_gravity.data(), num, dt);
+
+	for (int i = 0; i < num; ++i)
+	{
+		if (m_gravity[i] == 0.f)
+		{
+			continue;
+		}
+
+		// The bullet is turned by the angle between the old and the new velocities
+		float dot = m_prevVelX[i] * m_velX[i] + m_prevVelY[i] * m_velY[i];
+		float cross = m_prevVelX[i] * m_velY[i] - m_prevVelY[i] * m_velX[i];
+		float len = sqrtf(dot * dot + cross * cross);
+		if (len > 0.f)
+		{
+			float c = dot / len;
+			float s = cross / len;
+			float cosA = m_cos[i] * c - m_sin[i] * s;
+			float sinA = m_sin[i] * c + m_cos[i] * s;
+			m_cos[i] = cosA;
+			m_sin[i] = sinA;
+		}
+	}
+}
+
+void CBulletSystem::Update(sf::Time dt)
+{
+	const int num = GetNumBullets();
+	const float fDt = dt.asSeconds();
+	const float fLevelSize = CGame::Get().GetLogicalSystem()->GetLevelSystem()->GetLevelSize();
+
+	for (int i = 0; i < num; ++i)
+	{
+		const SBulletClass& bulletClass = m_classes[m_class[i]];
+
+		float x = m_posX[i] + m_velX[i] * fDt;
+		float y = m_posY[i] + m_velY[i] * fDt;
+
+		// The bullets are wrapped around the level in the same way as the entities (see CKinematics)
+		float wrappedX = x + (x < 0.f ? fLevelSize : 0.f) - (x > fLevelSize ? fLevelSize : 0.f);
+		float wrappedY = y + (y < 0.f ? fLevelSize : 0.f) - (y > fLevelSize ? fLevelSize : 0.f);
+
+		// The axis is swept from the previous position, unless the bullet has been wrapped
+		float prevX = wrappedX == x ? m_posX[i] : wrappedX;
+		float prevY = wrappedY == y ? m_posY[i] : wrappedY;
+
+		// The bullets move along their axes, so the front end is the one looking along the velocity
+		float hx = m_cos[i] * bulletClass.vHalfAxis.x - m_sin[i] * bulletClass.vHalfAxis.y;
+		float hy = m_sin[i] * bulletClass.vHalfAxis.x + m_cos[i] * bulletClass.vHalfAxis.y;
+		float sign = hx * m_velX[i] + hy * m_velY[i] >= 0.f ? 1.f : -1.f;
+
+		m_axisAX[i] = prevX - sign * hx;
+		m_axisAY[i] = prevY - sign * hy;
+		m_axisBX[i] = wrappedX + sign * hx;
+		m_axisBY[i] = wrappedY + sign * hy;
+
+		m_posX[i] = wrappedX;
+		m_posY[i] = wrappedY;
+		m_lifetime[i] -= fDt;
+	}
+
+	Collide();
+
+	for (int i = 0; i < GetNumBullets();)
+	{
+		// The last bullet is moved in place of the removed one, so it should be checked too
+		if (m_lifetime[i] <= 0.f)
+		{
+			RemoveBullet(i);
+		}
+		else
+		{
+			++i;
+		}
+	}
+}
+
+void CBulletSystem::CollectTargets()
+{
+	m_dNumTargets = 0;
+
+	const int num = GetNumBullets();
+	if (num == 0)
+	{
+		return;
+	}
+
+	const float fLevelSize = CGame::Get().GetLogicalSystem()->GetLevelSystem()->GetLevelSize();
+	const int numCells = std::max(1, (int)ceilf(fLevelSize / ClusterSize));
+	m_clusters.assign(numCells * numCells, { FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX });
+
+	for (int i = 0; i < num; ++i)
+	{
+		int x = std::clamp((int)(m_posX[i] / ClusterSize), 0, numCells - 1);
+		int y = std::clamp((int)(m_posY[i] / ClusterSize), 0, numCells - 1);
+		SCluster& cluster = m_clusters[y * numCells + x];
+
+		float fRad = m_rad[i];
+		cluster.left = std::min(cluster.left, std::min(m_axisAX[i], m_axisBX[i]) - fRad);
+		cluster.top = std::min(cluster.top, std::min(m_axisAY[i], m_axisBY[i]) - fRad);
+		cluster.right = std::max(cluster.right, std::max(m_axisAX[i], m_axisBX[i]) + fRad);
+		cluster.bottom = std::max(cluster.bottom, std::max(m_axisAY[i], m_axisBY[i]) + fRad);
+	}
+
+	uint32_t layerMask = 0;
+	for (const SBulletClass& bulletClass : m_classes)
+	{
+		layerMask |= bulletClass.filter.mask;
+	}
+
+	if (m_targetIds.size() < InitialNumTargets)
+	{
+		m_targetIds.resize(InitialNumTargets);
+	}
+
+	CPhysicalSystem* pPhysicalSystem = CGame::Get().GetPhysicalSystem();
+	int numFound = 0;
+	for (const SCluster& cluster : m_clusters)
+	{
+		if (cluster.left > cluster.right)
+		{
+			continue;
+		}
+
+		sf::FloatRect bounds(cluster.left, cluster.top, cluster.right - cluster.left, cluster.bottom - cluster.top);
+		while (true)
+		{
+			int maxResults = (int)m_targetIds.size() - numFound;
+			int numResults = pPhysicalSystem->QueryAABB(bounds, m_targetIds.data() + numFound, maxResults, layerMask);
+			if (numResults < maxResults)
+			{
+				numFound += numResults;
+				break;
+			}
+
+			// The buffer could be too small for all the targets, so it grows and the query is repeated
+			m_targetIds.resize(m_targetIds.size() * 2);
+		}
+	}
+
+	// The targets between the clusters are found several times
+	std::sort(m_targetIds.begin(), m_targetIds.begin() + numFound);
+	numFound = (int)(std::unique(m_targetIds.begin(), m_targetIds.begin() + numFound) - m_targetIds.begin());
+
+	m_targetAX.resize(numFound);
+	m_targetAY.resize(numFound);
+	m_targetBX.resize(numFound);
+	m_targetBY.resize(numFound);
+	m_targetRad.resize(numFound);
+	m_targetAccepts.resize(numFound * m_classes.size());
+
+	CLogicalSystem* pLogicalSystem = CGame::Get().GetLogicalSystem();
+	for (int i = 0; i < numFound; ++i)
+	{
+		CLogicalEntity* pEntity = pLogicalSystem->GetEntity(m_targetIds[i]);
+		const CPhysicalEntity* pPhysics = pEntity ? pPhysicalSystem->GetEntity(pEntity->GetPhysicalEntityId()) : nullptr;
+		if (!pPhysics || !pPhysics->GetPhysics())
+		{
+			continue;
+		}
+
+		int t = m_dNumTargets++;
+		m_targetIds[t] = m_targetIds[i];
+
+		sf::Vector2f vA, vB;
+		float fRad;
+		if (!PhysicalPrimitive::GetAxis(pPhysics->GetPhysics(), vA, vB, fRad))
+		{
+			vA = vB = pPhysics->GetPhysics()->GetBoundingCenter();
+			fRad = pPhysics->GetPhysics()->GetBoundingRadius();
+		}
+
+		m_targetAX[t] = vA.x;
+		m_targetAY[t] = vA.y;
+		m_targetBX[t] = vB.x;
+		m_targetBY[t] = vB.y;
+		m_targetRad[t] = fRad;
+
+		for (int c = 0; c < m_classes.size(); ++c)
+		{
+			m_targetAccepts[t * m_classes.size() + c] = m_classes[c].filter.Accepts(pPhysics->GetCollisionFilter());
+		}
+	}
+}
+
+void CBulletSystem::Collide()
+{
+	CollectTargets();
+
+	const int num = GetNumBullets();
+	std::fill(m_hitTargets.begin(), m_hitTargets.end(), InvalidLink);
+
+	for (int t = 0; t < m_dNumTargets; ++t)
+	{
+		const float p2x = m_targetAX[t];
+		const float p2y = m_targetAY[t];
+		const float d2x = m_targetBX[t] - p2x;
+		const float d2y = m_targetBY[t] - p2y;
+		const float e = std::max(d2x * d2x + d2y * d2y, FLT_MIN);
+		const float fTargetRad = m_targetRad[t];
+		const SmartId targetId = m_targetIds[t];
+		const uint8_t* pAccepts = &m_targetAccepts[t * m_classes.size()];
+
+		// The overlapping pairs are rare, so the filters are checked only for them.
+		// Each bullet keeps the first target it hits.
+		auto onOverlap = [&](int i)
+		{
+			if (m_hitTargets[i] == InvalidLink && pAccepts[m_class[i]] && m_owners[i] != targetId)
+			{
+				m_hitTargets[i] = t;
+			}
+		};
+
+		int i = 0;
+#ifdef BULLETS_SSE
+		const __m128 vP2x = _mm_set1_ps(p2x);
+		const __m128 vP2y = _mm_set1_ps(p2y);
+		const __m128 vD2x = _mm_set1_ps(d2x);
+		const __m128 vD2y = _mm_set1_ps(d2y);
+		const __m128 vE = _mm_set1_ps(e);
+		const __m128 vTargetRad = _mm_set1_ps(fTargetRad);
+
+		for (; i + 4 <= num; i += 4)
+		{
+			__m128 vDistSq = SegmentsDistanceSq(_mm_loadu_ps(&m_axisAX[i]), _mm_loadu_ps(&m_axisAY[i]),
+				_mm_loadu_ps(&m_axisBX[i]), _mm_loadu_ps(&m_axisBY[i]), vP2x, vP2y, vD2x, vD2y, vE);
+			__m128 vWidth = _mm_add_ps(_mm_loadu_ps(&m_rad[i]), vTargetRad);
+
+			if (int mask = _mm_movemask_ps(_mm_cmple_ps(vDistSq, _mm_mul_ps(vWidth, vWidth))))
+			{
+				for (int lane = 0; lane < 4; ++lane)
+				{
+					if (mask & (1 << lane))
+					{
+						onOverlap(i + lane);
+					}
+				}
+			}
+		}
+#endif
+
+		// The rest of the bullets, which don't fill the whole vector
+		for (; i < num; ++i)
+		{
+			float fWidth = m_rad[i] + fTargetRad;
+			if (SegmentsDistanceSq(m_axisAX[i], m_axisAY[i], m_axisBX[i], m_axisBY[i], p2x, p2y, d2x, d2y, e) <= fWidth * fWidth)
+			{
+				onOverlap(i);
+			}
+		}
+	}
+
+	CActorSystem* pActorSystem = CGame::Get().GetLogicalSystem()->GetActorSystem();
+	for (int i = 0; i < num; ++i)
+	{
+		if (m_hitTargets[i] != InvalidLink)
+		{
+			m_lifetime[i] = 0.f;
+			if (CActor* pActor = pActorSystem->GetActor(m_targetIds[m_hitTargets[i]]))
+			{
+				pActor->OnBulletHit(m_owners[i]);
+			}
+		}
+	}
+}
+
+void CBulletSystem::Render(float fLag)
+{
+	CRenderSystem* pRenderSystem = CGame::Get().GetRenderSystem();
+
+	m_classBatches.assign(m_classes.size(), nullptr);
+	for (int c = 0; c < m_classes.size(); ++c)
+	{
+		if (m_classes[c].textureId != -1)
+		{
+			m_classBatches[c] = &pRenderSystem->GetSpriteBatch(m_classes[c].textureId);
+		}
+	}
+
+	for (int i = 0; i < GetNumBullets(); ++i)
+	{
+		std::vector<sf::Vertex>* pVertices = m_classBatches[m_class[i]];
+		if (!pVertices)
+		{
+			continue;
+		}
+
+		// The quad is built in the same way as the sprite with the centered origin
+		const SBulletClass& bulletClass = m_classes[m_class[i]];
+		sf::Vector2f vRight = 0.5f * bulletClass.vSize.x * sf::Vector2f(m_cos[i], m_sin[i]);
+		sf::Vector2f vDown = 0.5f * bulletClass.vSize.y * sf::Vector2f(-m_sin[i], m_cos[i]);
+		sf::Vector2f vPos(m_posX[i] - m_velX[i] * fLag, m_posY[i] - m_velY[i] * fLag);
+		const sf::Vector2f& vTex = bulletClass.vTextureSize;
+
+		pVertices->emplace_back(vPos - vRight - vDown, sf::Vector2f(0.f, 0.f));
+		pVertices->emplace_back(vPos + vRight - vDown, sf::Vector2f(vTex.x, 0.f));
+		pVertices->emplace_back(vPos + vRight + vDown, sf::Vector2f(vTex.x, vTex.y));
+		pVertices->emplace_back(vPos - vRight + vDown, sf::Vector2f(0.f, vTex.y));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "EntitySystem.h"
+#include "Gravity.h"
+#include "PhysicalSystem/CollisionFilter.h"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include <SFML/System/Vector2.hpp>
+#include <SFML/System/Time.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+
+/**
+ * @class CBulletSystem
+ * Dedicated system for the projectiles, which are by far the most numerous objects
+ * in the game. The bullets are not the actors and have no logical, physical or render
+ * entities: their state is stored in the flat arrays, so they are moved, expired
+ * and collided in bulk. The shape and the look of the bullet are taken from the entity
+ * class (see CEntityConfiguration): it's a capsule moving along it's axis.
+ * The bullets are checked continuously against the round primitives (capsules and circles)
+ * of the physical entities accepted by the class' collision filter, the other primitives
+ * are approximated by their bounding circles. All the bullets of the same texture
+ * are drawn with a single vertex array (see CRenderSystem::GetSpriteBatch).
+ * The bullets are spawned by the server and replicated on the clients only once,
+ * then each side simulates them on it's own.
+ */
+class CBulletSystem
+{
+public:
+
+	CBulletSystem() = default;
+	CBulletSystem(const CBulletSystem&) = delete;
+
+	/**
+	 * @function Spawn
+	 * Create the new bullet and replicate it on the clients.
+	 *
+	 * @param entityClass - name of the entity class describing the bullet's shape and look.
+	 * @param ownerId - SmartId of the logical entity which shot the bullet. The bullet never hits it's owner.
+	 * @param vPos - initial position.
+	 * @param fRot - rotation in degrees, the bullet is aligned with it's direction.
+	 * @param vVel - velocity.
+	 * @param fLifetime - time in seconds after which the bullet expires.
+	 */
+	void Spawn(const std::string& entityClass, SmartId ownerId, const sf::Vector2f& vPos, float fRot, const sf::Vector2f& vVel, float fLifetime);
+
+	// Remove all the bullets on the server and the clients
+	void RemoveBullets();
+
+	void Clear();
+
+	/**
+	 * @function Update
+	 * Move all the bullets, expire the old ones and remove the ones which hit
+	 * the targets. The hit actors are notified (see CActor::OnBulletHit).
+	 * Should be called each frame after the kinematics' integration.
+	 *
+	 * @param dt - delta time since the last function call.
+	 */
+	void Update(sf::Time dt);
+
+	/**
+	 * @function ApplyGravity
+	 * Accelerate the bullets of the classes affected by the gravity and turn
+	 * them along their new velocities. Should be called before the update.
+	 *
+	 * @param gravity - gravity field of the level.
+	 * @param dt - time step in seconds.
+	 */
+	void ApplyGravity(const CGravity& gravity, float dt);
+
+	/**
+	 * @function Render
+	 * Write the quads of all the bullets into the render system's batches.
+	 * The bullets are moved back along their velocities by the render's lag,
+	 * so they are in time with the interpolated entities (see CRenderEntity).
+	 * Should be called each frame, even if the game is paused.
+	 *
+	 * @param fLag - time in seconds the render lags behind the last update.
+	 */
+	void Render(float fLag);
+
+	int GetNumBullets() const { return (int)m_lifetime.size(); }
+
+private:
+
+	struct SBulletClass
+	{
+		std::string name;
+		SCollisionFilter filter;
+		sf::Vector2f vHalfAxis; // from the center to the front end of the capsule's axis
+		float fRad = 0.f;
+		bool bGravity = false;
+		int textureId = -1;
+		sf::Vector2f vSize;
+		sf::Vector2f vTextureSize;
+	};
+
+	int FindClass(const std::string& name);
+
+	// Find the targets around the clusters of the bullets and store their axes
+	void CollectTargets();
+
+	// Test all the bullets against all the targets and notify the hit actors
+	void Collide();
+
+	void RemoveBullet(int idx);
+
+private:
+
+	std::vector<SBulletClass> m_classes;
+
+	// The bullets' state, the axis segment covers the bullet's motion during the last update
+	std::vector<float> m_posX;
+	std::vector<float> m_posY;
+	std::vector<float> m_velX;
+	std::vector<float> m_velY;
+	std::vector<float> m_cos;
+	std::vector<float> m_sin;
+	std::vector<float> m_lifetime;
+	std::vector<float> m_axisAX;
+	std::vector<float> m_axisAY;
+	std::vector<float> m_axisBX;
+	std::vector<float> m_axisBY;
+	std::vector<float> m_rad;
+	std::vector<float> m_gravity;
+	std::vector<int> m_class;
+	std::vector<SmartId> m_owners;
+	std::vector<int> m_hitTargets;
+
+	// The velocities before the gravity's application
+	std::vector<float> m_prevVelX;
+	std::vector<float> m_prevVelY;
+
+	// The bounds of the bullets in the cells of the level
+	struct SCluster
+	{
+		float left;
+		float top;
+		float right;
+		float bottom;
+	};
+
+	std::vector<SCluster> m_clusters;
+
+	// The targets' axes and their acceptance by each of the bullet classes
+	std::vector<SmartId> m_targetIds;
+	std::vector<float> m_targetAX;
+	std::vector<float> m_targetAY;
+	std::vector<float> m_targetBX;
+	std::vector<float> m_targetBY;
+	std::vector<float> m_targetRad;
+	std::vector<uint8_t> m_targetAccepts;
+	int m_dNumTargets = 0;
+
+	// The render system's batches of the classes' textures
+	std::vector<std::vector<sf::Vertex>*> m_classBatches;
+};
\ No newline at end of file
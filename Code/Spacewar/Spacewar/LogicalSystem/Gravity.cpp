@@ -0,0 +1,92 @@
+#include "StdAfx.h"
+#include "Gravity.h"
+
+// See the kinematics' SSE2 kernel
+#if !defined(SPACEWAR_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define GRAVITY_SSE
+#include <emmintrin.h>
+#endif
+
+void CGravity::Clear()
+{
+	m_posX.clear();
+	m_posY.clear();
+	m_force.clear();
+}
+
+void CGravity::AddSource(const sf::Vector2f& vPos, float fForce)
+{
+	m_posX.push_back(vPos.x);
+	m_posY.push_back(vPos.y);
+	m_force.push_back(fForce);
+}
+
+void CGravity::Apply(const float* posX, const float* posY, float* velX, float* velY, const float* scale, int num, float dt) const
+{
+	const int numSources = GetNumSources();
+	if (numSources == 0)
+	{
+		return;
+	}
+
+	int i = 0;
+
+#ifdef GRAVITY_SSE
+	const __m128 vZero = _mm_setzero_ps();
+	for (; i + 4 <= num; i += 4)
+	{
+		__m128 vScale = _mm_loadu_ps(scale + i);
+		__m128 vAffected = _mm_cmpneq_ps(vScale, vZero);
+		if (_mm_movemask_ps(vAffected) == 0)
+		{
+			continue;
+		}
+
+		__m128 vX = _mm_loadu_ps(posX + i);
+		__m128 vY = _mm_loadu_ps(posY + i);
+		__m128 vAccX = vZero;
+		__m128 vAccY = vZero;
+
+		for (int j = 0; j < numSources; ++j)
+		{
+			__m128 vDirX = _mm_sub_ps(_mm_set1_ps(m_posX[j]), vX);
+			__m128 vDirY = _mm_sub_ps(_mm_set1_ps(m_posY[j]), vY);
+			__m128 vLenSq = _mm_add_ps(_mm_mul_ps(vDirX, vDirX), _mm_mul_ps(vDirY, vDirY));
+			// The bodies in the very center of the source are not pulled
+			__m128 vK = _mm_and_ps(_mm_cmpgt_ps(vLenSq, vZero), _mm_div_ps(_mm_set1_ps(m_force[j]), vLenSq));
+			vAccX = _mm_add_ps(vAccX, _mm_mul_ps(vDirX, vK));
+			vAccY = _mm_add_ps(vAccY, _mm_mul_ps(vDirY, vK));
+		}
+
+		// The unaffected lanes are masked out, so they keep their velocities exactly as the scalar kernel does
+		__m128 vScaledDt = _mm_mul_ps(vScale, _mm_set1_ps(dt));
+		_mm_storeu_ps(velX + i, _mm_add_ps(_mm_loadu_ps(velX + i), _mm_and_ps(vAffected, _mm_mul_ps(vAccX, vScaledDt))));
+		_mm_storeu_ps(velY + i, _mm_add_ps(_mm_loadu_ps(velY + i), _mm_and_ps(vAffected, _mm_mul_ps(vAccY, vScaledDt))));
+	}
+#endif
+
+	for (; i < num; ++i)
+	{
+		if (scale[i] == 0.f)
+		{
+			continue;
+		}
+
+		float accX = 0.f;
+		float accY = 0.f;
+		for (int j = 0; j < numSources; ++j)
+		{
+			float dirX = m_posX[j] - posX[i];
+			float dirY = m_posY[j] - posY[i];
+			float lenSq = dirX * dirX + dirY * dirY;
+			if (lenSq > 0.f)
+			{
+				accX += dirX * m_force[j] / lenSq;
+				accY += dirY * m_force[j] / lenSq;
+			}
+		}
+
+		velX[i] += accX * scale[i] * dt;
+		velY[i] += accY * scale[i] * dt;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+
+#include <SFML/System/Vector2.hpp>
+
+/**
+ * @class CGravity
+ * Gravity field of the holes. The sources are gathered once per frame
+ * and their summed pull is applied to the whole arrays of the bodies
+ * in a single pass, the sources being the inner loop. The pull of a source
+ * is inversely proportional to the distance to it, like it was in the holes'
+ * own updates, so no square roots are needed.
+ */
+class CGravity
+{
+public:
+
+	void Clear();
+	void AddSource(const sf::Vector2f& vPos, float fForce);
+	int GetNumSources() const { return (int)m_force.size(); }
+
+	/**
+	 * @function Apply
+	 * Accelerate the bodies towards all the sources.
+	 *
+	 * @param posX, posY - positions of the bodies.
+	 * @param velX, velY - velocities of the bodies to be changed.
+	 * @param scale - gravity scale of each body, the bodies with zero scale are not affected.
+	 * @param num - number of the bodies.
+	 * @param dt - time step in seconds.
+	 */
+	void Apply(const float* posX, const float* posY, float* velX, float* velY, const float* scale, int num, float dt) const;
+
+private:
+
+	std::vector<float> m_posX;
+	std::vector<float> m_posY;
+	std::vector<float> m_force;
+};
\ No newline at end of file
@@ -4,21 +4,23 @@
 
 /**
  * @class CHole
- * Hole is an actor placed in the world, that gravitate all the players to itself.
+ * Hole is an actor placed in the world, that gravitate all the players to itself
+ * (the pull of all the holes is applied at once, see CGravity).
  * Also holes teleportate players, which it collides with, in the random point on the map.
  * This class describes all the holes' logic.
  */
-class CHole : public CActor
+class CHole final : public CActor
 {
 public:
 
 	CHole(const std::string& entity);
 
 	void SetGravityForce(float fGravityForce);
+	float GetGravityForce() const { return m_fGravityForce; }
 
-	virtual void OnCollision(SmartId sid) override;
+	virtual void OnCollisionBegin(SmartId sid) override;
 	virtual EActorType GetType() const override { return EActorType_Hole; }
-	virtual void Update(sf::Time dt) override;
+	virtual void Update(sf::Time dt) override {}
 	virtual void Serialize(sf::Packet& packet, uint8_t mode, uint16_t& size) override;
 
 private:
@@ -0,0 +1,230 @@
+#include "StdAfx.h"
+#include "Kinematics.h"
+
+#include <cmath>
+#include <algorithm>
+#include <cstring>
+
+int CKinematics::Add(SmartId sid, bool bGravity)
+{
+	int idx = GetSmartIdIndex(sid);
+	if (idx >= (int)m_sids.size())
+	{
+		size_t size = idx + 1;
+		m_posX.resize(size);
+		m_posY.resize(size);
+		m_velX.resize(size);
+		m_velY.resize(size);
+		m_rot.resize(size);
+		m_angSpeed.resize(size);
+		m_scale.resize(size);
+		m_gravity.resize(size);
+		m_active.resize(size);
+		m_changed.resize(size);
+		m_sids.resize(size, InvalidLink);
+		m_transforms.resize(size);
+	}
+
+	m_posX[idx] = m_posY[idx] = 0.f;
+	m_velX[idx] = m_velY[idx] = 0.f;
+	m_rot[idx] = 0.f;
+	m_angSpeed[idx] = 0.f;
+	m_scale[idx] = 1.f;
+	m_gravity[idx] = bGravity ? 1.f : 0.f;
+	m_active[idx] = 1;
+	m_changed[idx] = 0;
+	m_sids[idx] = sid;
+	m_transforms[idx] = sf::Transform::Identity;
+
+	return idx;
+}
+
+void CKinematics::Remove(int idx)
+{
+	m_gravity[idx] = 0.f;
+	m_active[idx] = 0;
+	m_changed[idx] = 0;
+	m_sids[idx] = InvalidLink;
+}
+
+void CKinematics::Clear()
+{
+	std::fill(m_gravity.begin(), m_gravity.end(), 0.f);
+	std::fill(m_active.begin(), m_active.end(), 0);
+	std::fill(m_changed.begin(), m_changed.end(), 0);
+	std::fill(m_sids.begin(), m_sids.end(), InvalidLink);
+}
+
+// The SSE2 kernel is available on all the x64 targets and can be
+// disabled with SPACEWAR_NO_SIMD to compare it with the scalar one
+#if !defined(SPACEWAR_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define KINEMATICS_SSE
+#include <emmintrin.h>
+#endif
+
+struct SIntegrationArrays
+{
+	float* __restrict posX;
+	float* __restrict posY;
+	float* __restrict rot;
+	const float* __restrict velX;
+	const float* __restrict velY;
+	const float* __restrict angSpeed;
+	const uint8_t* __restrict active;
+	uint8_t* __restrict changed;
+};
+
+// Both kernels return the number of the moved slots, which were already marked as changed
+static int IntegrateScalar(const SIntegrationArrays& arr, int begin, int end, float dt, float fLevelSize)
+{
+	int coalesced = 0;
+
+	for (int i = begin; i < end; ++i)
+	{
+		float x = arr.posX[i] + arr.velX[i] * dt;
+		float y = arr.posY[i] + arr.velY[i] * dt;
+		float r = arr.rot[i] + arr.angSpeed[i] * dt;
+
+		x += (x < 0.f ? fLevelSize : 0.f) - (x > fLevelSize ? fLevelSize : 0.f);
+		y += (y < 0.f ? fLevelSize : 0.f) - (y > fLevelSize ? fLevelSize : 0.f);
+		r += (r < 0.f ? 360.f : 0.f) - (r >= 360.f ? 360.f : 0.f);
+
+		uint8_t moved = arr.active[i] & (uint8_t)((x != arr.posX[i]) | (y != arr.posY[i]) | (r != arr.rot[i]));
+		coalesced += arr.changed[i] & moved;
+		arr.changed[i] |= moved;
+
+		arr.posX[i] = x;
+		arr.posY[i] = y;
+		arr.rot[i] = r;
+	}
+
+	return coalesced;
+}
+
+#ifdef KINEMATICS_SSE
+// Shift the values by the range size where the masks are set in the same way as
+// the scalar kernel: both masks are calculated before the correction is applied
+static inline __m128 Wrap(__m128 v, __m128 vRange, __m128 vLessMask, __m128 vGreaterMask)
+{
+	return _mm_sub_ps(_mm_add_ps(v, _mm_and_ps(vLessMask, vRange)), _mm_and_ps(vGreaterMask, vRange));
+}
+
+// Bit i of the index is expanded into the byte i (little endian)
+static constexpr uint32_t MaskToBytes[16] =
+{
+	0x00000000, 0x00000001, 0x00000100, 0x00000101,
+	0x00010000, 0x00010001, 0x00010100, 0x00010101,
+	0x01000000, 0x01000001, 0x01000100, 0x01000101,
+	0x01010000, 0x01010001, 0x01010100, 0x01010101,
+};
+
+static int IntegrateSSE(const SIntegrationArrays& arr, int num, float dt, float fLevelSize, int& processed)
+{
+	int coalesced = 0;
+
+	const __m128 vDt = _mm_set1_ps(dt);
+	const __m128 vLevelSize = _mm_set1_ps(fLevelSize);
+	const __m128 vFullCircle = _mm_set1_ps(360.f);
+	const __m128 vZero = _mm_setzero_ps();
+
+	int i = 0;
+	for (; i + 4 <= num; i += 4)
+	{
+		__m128 vOldX = _mm_loadu_ps(arr.posX + i);
+		__m128 vOldY = _mm_loadu_ps(arr.posY + i);
+		__m128 vOldRot = _mm_loadu_ps(arr.rot + i);
+
+		__m128 vX = _mm_add_ps(vOldX, _mm_mul_ps(_mm_loadu_ps(arr.velX + i), vDt));
+		__m128 vY = _mm_add_ps(vOldY, _mm_mul_ps(_mm_loadu_ps(arr.velY + i), vDt));
+		__m128 vRot = _mm_add_ps(vOldRot, _mm_mul_ps(_mm_loadu_ps(arr.angSpeed + i), vDt));
+
+		vX = Wrap(vX, vLevelSize, _mm_cmplt_ps(vX, vZero), _mm_cmpgt_ps(vX, vLevelSize));
+		vY = Wrap(vY, vLevelSize, _mm_cmplt_ps(vY, vZero), _mm_cmpgt_ps(vY, vLevelSize));
+		vRot = Wrap(vRot, vFullCircle, _mm_cmplt_ps(vRot, vZero), _mm_cmpge_ps(vRot, vFullCircle));
+
+		__m128 vMoved = _mm_or_ps(_mm_or_ps(_mm_cmpneq_ps(vX, vOldX), _mm_cmpneq_ps(vY, vOldY)), _mm_cmpneq_ps(vRot, vOldRot));
+		// The lanes' mask is expanded into the four flag bytes at once
+		uint32_t active, changed;
+		memcpy(&active, arr.active + i, sizeof(active));
+		memcpy(&changed, arr.changed + i, sizeof(changed));
+		uint32_t moved = active & MaskToBytes[_mm_movemask_ps(vMoved)];
+		// Sum of the bytes, each of them is either 0 or 1
+		coalesced += (int)(((changed & moved) * 0x01010101u) >> 24);
+		changed |= moved;
+		memcpy(arr.changed + i, &changed, sizeof(changed));
+
+		_mm_storeu_ps(arr.posX + i, vX);
+		_mm_storeu_ps(arr.posY + i, vY);
+		_mm_storeu_ps(arr.rot + i, vRot);
+	}
+
+	processed = i;
+	return coalesced;
+}
+#endif
+
+void CKinematics::Integrate(float dt, float fLevelSize)
+{
+	const int num = (int)m_sids.size();
+
+	SIntegrationArrays arr{ m_posX.data(), m_posY.data(), m_rot.data(),
+		m_velX.data(), m_velY.data(), m_angSpeed.data(), m_active.data(), m_changed.data() };
+
+	int processed = 0;
+#ifdef KINEMATICS_SSE
+	m_dNumCoalescedUpdates += IntegrateSSE(arr, num, dt, fLevelSize, processed);
+#endif
+
+	// The rest of the slots, which don't fill the whole vector
+	m_dNumCoalescedUpdates += IntegrateScalar(arr, processed, num, dt, fLevelSize);
+}
+
+void CKinematics::MarkChanged(int idx)
+{
+	m_dNumCoalescedUpdates += m_changed[idx];
+	m_changed[idx] = m_active[idx];
+	UpdateTransform(idx);
+}
+
+void CKinematics::ApplyGravity(const CGravity& gravity, float dt)
+{
+	gravity.Apply(m_posX.data(), m_posY.data(), m_velX.data(), m_velY.data(), m_gravity.data(), (int)m_gravity.size(), dt);
+}
+
+void CKinematics::SetPosition(int idx, const sf::Vector2f& vPos)
+{
+	m_posX[idx] = vPos.x;
+	m_posY[idx] = vPos.y;
+	MarkChanged(idx);
+}
+
+void CKinematics::SetRotation(int idx, float fRot)
+{
+	// Keep the rotation in [0, 360) as sf::Transformable does
+	fRot = fmodf(fRot, 360.f);
+	m_rot[idx] = fRot < 0.f ? fRot + 360.f : fRot;
+	MarkChanged(idx);
+}
+
+void CKinematics::SetScale(int idx, float fScale)
+{
+	m_scale[idx] = fScale;
+	MarkChanged(idx);
+}
+
+void CKinematics::SetVelocity(int idx, const sf::Vector2f& vVel)
+{
+	m_velX[idx] = vVel.x;
+	m_velY[idx] = vVel.y;
+}
+
+void CKinematics::UpdateTransform(int idx)
+{
+	float fAngle = -m_rot[idx] * 3.141592654f / 180.f;
+	float fCos = cosf(fAngle) * m_scale[idx];
+	float fSin = sinf(fAngle) * m_scale[idx];
+
+	m_transforms[idx] = sf::Transform(fCos, fSin, m_posX[idx],
+		-fSin, fCos, m_posY[idx],
+		0.f, 0.f, 1.f);
+}
\ No newline at end of file
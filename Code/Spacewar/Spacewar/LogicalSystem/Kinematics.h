@@ -0,0 +1,126 @@
+#pragma once
+
+#include "EntitySystem.h"
+#include "Gravity.h"
+
+#include <vector>
+#include <cstdint>
+
+#include <SFML/System/Vector2.hpp>
+#include <SFML/Graphics/Transform.hpp>
+
+/**
+ * @class CKinematics
+ * Structure of arrays storing the kinematic state of the logical entities:
+ * position, velocity, rotation, angular speed and scale. Each component
+ * lives in its own array indexed by the link index of the entity's SmartId,
+ * so the integration of all the entities is a single tight pass over
+ * a few contiguous arrays. The transforms are rebuilt only for the entities
+ * whose state has actually changed.
+ * Both the integration and the setters just mark the slots as changed,
+ * so the changes of an entity during the frame are flushed only once.
+ */
+class CKinematics
+{
+public:
+
+	/**
+	 * @function Add
+	 * Reset the state in the slot of the entity and mark it active.
+	 *
+	 * @param sid - SmartId of the entity.
+	 * @param bGravity - if the entity is pulled by the holes (see ApplyGravity).
+	 * @return index of the entity's slot.
+	 */
+	int Add(SmartId sid, bool bGravity = false);
+
+	// Deactivate the slot, so it's skipped by the integration
+	void Remove(int idx);
+
+	void Clear();
+
+	/**
+	 * @function Integrate
+	 * Move and rotate all the active entities in respect with their velocities
+	 * and wrap them around the level boundaries. The entities with the changed
+	 * position or rotation are marked to be processed by ForEachChanged.
+	 *
+	 * @param dt - time step in seconds.
+	 * @param fLevelSize - length of the level's side.
+	 */
+	void Integrate(float dt, float fLevelSize);
+
+	/**
+	 * @function ApplyGravity
+	 * Accelerate all the active entities affected by the gravity.
+	 * Should be called before the integration.
+	 *
+	 * @param gravity - gravity field of the level.
+	 * @param dt - time step in seconds.
+	 */
+	void ApplyGravity(const CGravity& gravity, float dt);
+
+	/**
+	 * @function ForEachChanged
+	 * Rebuild the transforms of the entities changed since the last call and reset the marks.
+	 *
+	 * @param f - function which is called with the SmartId of each changed entity.
+	 */
+	template <typename F>
+	void ForEachChanged(F&& f)
+	{
+		for (int i = 0; i < (int)m_changed.size(); ++i)
+		{
+			if (m_changed[i])
+			{
+				m_changed[i] = 0;
+				UpdateTransform(i);
+				f(m_sids[i]);
+			}
+		}
+	}
+
+	// The setters of the transform components mark the slot as changed.
+	// The transform is rebuilt immediately, so it can be read before the flush.
+	void SetPosition(int idx, const sf::Vector2f& vPos);
+	void SetRotation(int idx, float fRot);
+	void SetScale(int idx, float fScale);
+	void SetVelocity(int idx, const sf::Vector2f& vVel);
+	void SetAngularSpeed(int idx, float fAngSpeed) { m_angSpeed[idx] = fAngSpeed; }
+
+	sf::Vector2f GetPosition(int idx) const { return sf::Vector2f(m_posX[idx], m_posY[idx]); }
+	sf::Vector2f GetVelocity(int idx) const { return sf::Vector2f(m_velX[idx], m_velY[idx]); }
+	float GetRotation(int idx) const { return m_rot[idx]; }
+	float GetAngularSpeed(int idx) const { return m_angSpeed[idx]; }
+	float GetScale(int idx) const { return m_scale[idx]; }
+	const sf::Transform& GetTransform(int idx) const { return m_transforms[idx]; }
+
+	// The number of the changes merged with the ones already pending in the same slot
+	int GetNumCoalescedUpdates() const { return m_dNumCoalescedUpdates; }
+	void ResetNumCoalescedUpdates() { m_dNumCoalescedUpdates = 0; }
+
+private:
+
+	void MarkChanged(int idx);
+
+	// Build the transform from the current state of the slot
+	void UpdateTransform(int idx);
+
+private:
+
+	std::vector<float> m_posX;
+	std::vector<float> m_posY;
+	std::vector<float> m_velX;
+	std::vector<float> m_velY;
+	std::vector<float> m_rot;
+	std::vector<float> m_angSpeed;
+	std::vector<float> m_scale;
+	std::vector<float> m_gravity; // zero for the inactive slots
+	std::vector<uint8_t> m_active;
+	std::vector<uint8_t> m_changed;
+
+	std::vector<SmartId> m_sids;
+	std::vector<sf::Transform> m_transforms;
+
+	int m_dNumCoalescedUpdates = 0;
+};
\ No newline at end of file
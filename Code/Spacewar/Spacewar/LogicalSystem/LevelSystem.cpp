@@ -3,6 +3,7 @@
 #include "Game.h"
 #include "LogicalSystem.h"
 #include "ActorSystem.h"
+#include "BulletSystem.h"
 #include "Player.h"
 #include "Hole.h"
 #include "ConfigurationSystem/ConfigurationSystem.h"
@@ -164,7 +165,7 @@ void CLevelSystem::RecoverPlayers()
 		m_savedPlayers.clear();
 	}
 
-	m_fReviveCooldown = 0.f;
+	CGame::Get().GetLogicalSystem()->GetTimers()->Cancel(m_reviveTimer);
 }
 
 void CLevelSystem::GenerateStars()
@@ -375,7 +376,9 @@ void CLevelSystem::ScheduleBonus()
 {
 	if (m_pLevelConfig)
 	{
-		m_fNextBonusCooldown = m_pLevelConfig->bonuses.fCooldownMin + (m_pLevelConfig->bonuses.fCooldownMax - m_pLevelConfig->bonuses.fCooldownMin) * RandFloat();
+		CTimerWheel* pTimers = CGame::Get().GetLogicalSystem()->GetTimers();
+		pTimers->Cancel(m_bonusTimer);
+		m_bonusTimer = pTimers->Schedule(m_pLevelConfig->bonuses.fCooldownMin + (m_pLevelConfig->bonuses.fCooldownMax - m_pLevelConfig->bonuses.fCooldownMin) * RandFloat(), this, ETimer_Bonus);
 	}
 }
 
@@ -383,31 +386,31 @@ void CLevelSystem::ScheduleRevive()
 {
 	if (m_pLevelConfig)
 	{
-		m_fReviveCooldown = m_pLevelConfig->fReviveDelay;
+		CTimerWheel* pTimers = CGame::Get().GetLogicalSystem()->GetTimers();
+		pTimers->Cancel(m_reviveTimer);
+		m_reviveTimer = pTimers->Schedule(m_pLevelConfig->fReviveDelay, this, ETimer_Revive);
 	}
 }
 
-void CLevelSystem::Update(sf::Time dt)
+void CLevelSystem::OnTimer(int tag)
 {
-	if (!m_pLevelConfig)
+	if (!m_pLevelConfig || !CGame::Get().IsServer())
 	{
 		return;
 	}
 
-	m_fNextBonusCooldown -= dt.asSeconds();
-	if (CGame::Get().IsServer() && m_pLevelConfig->bAllowConsumables && m_fNextBonusCooldown <= 0.f)
-	{
-		SpawnBonus(m_pLevelConfig->bonuses.bonuses[RandInt(0, (int)(m_pLevelConfig->bonuses.bonuses.size() - 1))]);
-	}
-
-	if (CGame::Get().IsServer() && m_fReviveCooldown > 0.f)
+	switch (tag)
 	{
-		m_fReviveCooldown -= dt.asSeconds();
-		if (m_fReviveCooldown <= 0.f)
+	case ETimer_Bonus:
+		if (m_pLevelConfig->bAllowConsumables)
 		{
-			RecoverPlayers();
-			CGame::Get().GetLogicalSystem()->GetActorSystem()->RemoveProjectiles();
+			SpawnBonus(m_pLevelConfig->bonuses.bonuses[RandInt(0, (int)(m_pLevelConfig->bonuses.bonuses.size() - 1))]);
 		}
+		break;
+	case ETimer_Revive:
+		RecoverPlayers();
+		CGame::Get().GetLogicalSystem()->GetBulletSystem()->RemoveBullets();
+		break;
 	}
 }
 
@@ -18,7 +18,7 @@
  * game rules logic like players' or bonuses' spawning.
  * Levels are also configured in the xml (see CLevelConfiguration).
  */
-class CLevelSystem
+class CLevelSystem : public ITimerListener
 {
 public:
 
@@ -103,12 +103,11 @@ public:
 	void TeleportEntity(CLogicalEntity* pEntity, const sf::Vector2f& vOrg);
 
 	/**
-	 * @function Update
-	 * Function to update the level state. Should be called each frame.
-	 *
-	 * @param dt - delta time since the last function call.
+	 * @function OnTimer
+	 * ITimerListener implementation. Spawns the scheduled bonuses
+	 * and revives the players after the round's end.
 	 */
-	void Update(sf::Time dt);
+	virtual void OnTimer(int tag) override;
 
 	/**
 	 * @function GetLevelSize
@@ -158,9 +157,14 @@ private:
 
 	std::vector<SmartId> m_playerSpawners;
 
-	float m_fNextBonusCooldown = 0.f;
-	float m_fNextHoleCooldown = 0.f;
-	float m_fReviveCooldown = 0.f;
+	enum ETimer
+	{
+		ETimer_Bonus,
+		ETimer_Revive,
+	};
+
+	SmartId m_bonusTimer = InvalidLink;
+	SmartId m_reviveTimer = InvalidLink;
 
 	struct SPlayerInfo
 	{
@@ -8,50 +8,39 @@
 
 void CLogicalEntity::OnTransformUpdated()
 {
-	if (CPhysicalEntity* pPhysicalEntity = CGame::Get().GetPhysicalSystem()->GetEntity(m_physicalEntityId))
-	{
-		pPhysicalEntity->OnTransformChanged(getTransform());
-	}
-	CGame::Get().GetRenderProxy()->OnCommand<RenderCommand::SetTransformCommand>(m_renderEntityId, getTransform());
+	const sf::Transform& transform = GetTransform();
+	CGame::Get().GetPhysicalSystem()->OnEntityTransformChanged(m_physicalEntityId, transform);
+	CGame::Get().GetRenderProxy()->OnCommand<RenderCommand::SetTransformCommand>(m_renderEntityId, transform);
 }
 
 void CLogicalEntity::SetPosition(const sf::Vector2f& vPos)
 {
-	if (vPos != getPosition())
+	if (vPos != GetPosition())
 	{
-		setPosition(vPos);
-		OnTransformUpdated();
+		m_pKinematics->SetPosition(m_dKinematicsIdx, vPos);
 	}
 }
 
 void CLogicalEntity::SetRotation(float fRot)
 {
-	if (fRot != getRotation())
+	if (fRot != GetRotation())
 	{
-		setRotation(fRot);
-		OnTransformUpdated();
+		m_pKinematics->SetRotation(m_dKinematicsIdx, fRot);
 	}
 }
 
 void CLogicalEntity::SetScale(float fScale)
 {
-	if (fScale != getScale().x)
+	if (fScale != GetScale())
 	{
-		setScale(sf::Vector2f(fScale, fScale));
-		OnTransformUpdated();
+		m_pKinematics->SetScale(m_dKinematicsIdx, fScale);
 	}
 }
 
-void CLogicalEntity::Update(sf::Time dt)
-{
-	SetPosition(GetPosition() + m_vVel * dt.asSeconds());
-	SetRotation(GetRotation() + m_fAngSpeed * dt.asSeconds());
-}
-
 sf::Vector2f CLogicalEntity::GetForwardDirection() const
 {
 	static sf::Vector2f ForwardVector(0.f, 1.f);
-	return MathHelpers::Normalize(getTransform().transformPoint(ForwardVector) - getPosition());
+	return MathHelpers::Normalize(GetTransform().transformPoint(ForwardVector) - GetPosition());
 }
 
 void CLogicalEntity::AddRenderSlot(const SRenderSlot& slot)
@@ -1,10 +1,10 @@
 #pragma once
 
 #include "EntitySystem.h"
+#include "Kinematics.h"
 
 #include <vector>
 
-#include <SFML/Graphics/Transformable.hpp>
 #include <SFML/System/Time.hpp>
 
 class CPhysicalEntity;
@@ -16,8 +16,10 @@ class CRenderEntity;
  * moving, rotating and scaling. It also obtain can own a physical
  * entity and a few render entities (render slots), which are
  * synced with the parent logical entity.
+ * The kinematic state of the entity is kept in the CKinematics arrays
+ * of the logical system, the entity only refers to it's slot there.
  */
-class CLogicalEntity : public CEntity, private sf::Transformable
+class CLogicalEntity : public CEntity
 {
 public:
 
@@ -31,6 +33,7 @@ public:
 
 	void SetPhysics(SmartId sid) { m_physicalEntityId = sid; }
 	void SetRender(SmartId sid) { m_renderEntityId = sid; }
+	void SetKinematics(CKinematics* pKinematics, int idx) { m_pKinematics = pKinematics; m_dKinematicsIdx = idx; }
 
 	void AddRenderSlot(const SRenderSlot& slot);
 
@@ -46,48 +49,39 @@ public:
 
 	int GetActiveRenderSlot() const { return m_dActiveRenderSlot; }
 
-	// Functions changing the current entity transform.
-	// They are also trigger callbacks which transform the owned physical and render entities.
+	// Functions changing the current entity transform. The owned physical and render
+	// entities are transformed once per frame, when the logical system flushes the transforms.
 	void SetPosition(const sf::Vector2f& vPos);
 	void SetRotation(float fRot);
 	void SetScale(float fScale);
 
-	void SetVelocity(const sf::Vector2f& vVel) { m_vVel = vVel; }
-	void SetAngularSpeed(float fAngSpeed) { m_fAngSpeed = fAngSpeed; }
+	void SetVelocity(const sf::Vector2f& vVel) { m_pKinematics->SetVelocity(m_dKinematicsIdx, vVel); }
+	void SetAngularSpeed(float fAngSpeed) { m_pKinematics->SetAngularSpeed(m_dKinematicsIdx, fAngSpeed); }
 
-	const sf::Vector2f& GetPosition() const { return getPosition(); }
-	float GetRotation() const { return getRotation(); }
-	float GetScale() const { return getScale().x; }
-	const sf::Transform& GetTransform() const { return getTransform(); }
+	sf::Vector2f GetPosition() const { return m_pKinematics->GetPosition(m_dKinematicsIdx); }
+	float GetRotation() const { return m_pKinematics->GetRotation(m_dKinematicsIdx); }
+	float GetScale() const { return m_pKinematics->GetScale(m_dKinematicsIdx); }
+	const sf::Transform& GetTransform() const { return m_pKinematics->GetTransform(m_dKinematicsIdx); }
 
-	const sf::Vector2f& GetVelocity() const { return m_vVel; }
-	float GetAngularSpeed() const { return m_fAngSpeed; }
+	sf::Vector2f GetVelocity() const { return m_pKinematics->GetVelocity(m_dKinematicsIdx); }
+	float GetAngularSpeed() const { return m_pKinematics->GetAngularSpeed(m_dKinematicsIdx); }
 	sf::Vector2f GetForwardDirection() const;
 
+	int GetKinematicsIdx() const { return m_dKinematicsIdx; }
 	SmartId GetPhysicalEntityId() { return m_physicalEntityId; }
 	SmartId GetRenderEntityId() { return m_renderEntityId; }
-	
-	/**
-	 * @function Update
-	 * This function performs moving and rotating of the entity
-	 * accordingly with the set velocity and angular speed.
-	 * Should be called every frame.
-	 * 
-	 * @param dt - time since the last function call.
-	 */
-	void Update(sf::Time dt);
-
-private:
 
+	// Send the current transform to the owned physical and render entities.
+	// Called by the logical system for the changed entities on the transforms flush.
 	void OnTransformUpdated();
 
 private:
 
 	SmartId m_physicalEntityId = InvalidLink;
 	SmartId m_renderEntityId = InvalidLink;
-	
-	sf::Vector2f m_vVel;
-	float m_fAngSpeed = 0.f;
+
+	CKinematics* m_pKinematics = nullptr;
+	int m_dKinematicsIdx = InvalidLink;
 
 	int m_dActiveRenderSlot = 0;
 	std::vector<SRenderSlot> m_renderSlots;
@@ -5,17 +5,24 @@
 #include "LevelSystem.h"
 #include "Player.h"
 #include "FeedbackSystem.h"
+#include "BulletSystem.h"
 #include "ConfigurationSystem/ConfigurationSystem.h"
 #include "ConfigurationSystem/EntityConfiguration.h"
 #include "PhysicalSystem/PhysicalSystem.h"
 #include "RenderSystem/RenderSystem.h"
 #include "RenderSystem/RenderProxy.h"
+#include "AllocationCounter.h"
+
+// The pooled entities are recycled and reused without the allocations, once the pools are filled
+static CAllocationCheck s_reuseAllocationCheck("CLogicalSystem::ReuseEntity", 16, 64);
+static CAllocationCheck s_recycleAllocationCheck("CLogicalSystem::RecycleEntity", 16, 64);
 
 CLogicalSystem::CLogicalSystem()
 	: CEntitySystem(64)
 	, m_pActorSystem(std::make_unique<CActorSystem>())
 	, m_pLevelSystem(std::make_unique<CLevelSystem>())
 	, m_pFeedbackSystem(std::make_unique<CFeedbackSystem>())
+	, m_pBulletSystem(std::make_unique<CBulletSystem>())
 {}
 
 CLogicalSystem::~CLogicalSystem() = default;
@@ -25,46 +32,90 @@ void CLogicalSystem::Release()
 	m_pActorSystem.reset();
 	m_pLevelSystem.reset();
 	m_pFeedbackSystem.reset();
+	m_pBulletSystem.reset();
+	m_timers.Clear();
 }
 
 void CLogicalSystem::Update(sf::Time dt)
 {
+	m_timers.Advance(dt.asSeconds());
+	m_statistics.numExpiredTimers = m_timers.GetNumExpired();
+
 	m_pActorSystem->Update(dt);
-	m_pLevelSystem->Update(dt);
 
-	float levelSize = m_pLevelSystem->GetLevelSize();
-	auto checkLevelBoundaries = [levelSize](float coord) -> float
-	{
-		if (coord < 0.f)
-			return levelSize + coord;
-		if (coord > levelSize)
-			return coord - levelSize;
-		return coord;
-	};
-	
-	ForEachEntity([&](CLogicalEntity& entity) 
-		{ 
-			entity.Update(dt);
-
-			sf::Vector2f vPos = entity.GetPosition();
-			vPos.x = checkLevelBoundaries(vPos.x);
-			vPos.y = checkLevelBoundaries(vPos.y);
-			entity.SetPosition(vPos);
+	ApplyGravity(dt.asSeconds());
+
+	m_kinematics.Integrate(dt.asSeconds(), m_pLevelSystem->GetLevelSize());
+
+	// The bullets collide with the physical entities in their current poses
+	FlushTransforms();
+	m_pBulletSystem->Update(dt);
+}
+
+void CLogicalSystem::ApplyGravity(float dt)
+{
+	m_gravity.Clear();
+	m_pActorSystem->ForEachHole([this](CHole* pHole)
+		{
+			if (CLogicalEntity* pEntity = pHole->GetEntity())
+			{
+				m_gravity.AddSource(pEntity->GetPosition(), pHole->GetGravityForce());
+			}
+			return true;
+		});
+
+	m_kinematics.ApplyGravity(m_gravity, dt);
+	m_pBulletSystem->ApplyGravity(m_gravity, dt);
+}
+
+void CLogicalSystem::FlushTransforms()
+{
+	m_statistics.numFlushes = 0;
+	m_kinematics.ForEachChanged([this](SmartId sid)
+		{
+			if (CLogicalEntity* pEntity = GetEntity(sid))
+			{
+				pEntity->OnTransformUpdated();
+				++m_statistics.numFlushes;
+			}
 		});
+
+	m_statistics.numCoalescedUpdates = m_kinematics.GetNumCoalescedUpdates();
+	m_kinematics.ResetNumCoalescedUpdates();
+}
+
+void CLogicalSystem::Render(float fLag)
+{
+	m_pBulletSystem->Render(fLag);
 }
 
 SmartId CLogicalSystem::CreateEntityFromClass(const std::string& name)
 {
 	if (const CEntityConfiguration::SEntityClass* pEntityClass = CGame::Get().GetConfigurationSystem()->GetEntityConfiguration()->GetEntityClass(name))
 	{
+		if (pEntityClass->poolSize > 0)
+		{
+			SmartId sid = ReuseEntity(pEntityClass);
+			if (sid != InvalidLink)
+			{
+				++m_statistics.numPoolHits;
+				return sid;
+			}
+			++m_statistics.numPoolMisses;
+		}
+
 		SmartId sid = CreateEntity();
 
 		if (CLogicalEntity* pEntity = GetEntity(sid))
 		{
+			pEntity->SetKinematics(&m_kinematics, m_kinematics.Add(sid, pEntityClass->bGravity));
+			SetEntityClass(sid, pEntityClass);
+
 			if (pEntityClass->physicsType != PhysicalPrimitive::EPrimitiveType_Num)
 			{
 				CPhysicalSystem* pPhysicalSystem = CGame::Get().GetPhysicalSystem();
-				SmartId physicalEntityId = pPhysicalSystem->CreateEntityWithPrimitive(pEntityClass->physicsType, pEntityClass->pPhysics.get());
+				SmartId physicalEntityId = pPhysicalSystem->CreateEntityWithPrimitive(pEntityClass->physicsType, pEntityClass->pPhysics.get(),
+					pEntityClass->collisionFilter, pEntityClass->bFastPhysics);
 				pEntity->SetPhysics(physicalEntityId);
 				if (CPhysicalEntity* pPhysics = pPhysicalSystem->GetEntity(physicalEntityId))
 				{
@@ -91,10 +142,99 @@ SmartId CLogicalSystem::CreateEntityFromClass(const std::string& name)
 	return InvalidLink;
 }
 
+void CLogicalSystem::SetEntityClass(SmartId sid, const SEntityClass* pEntityClass)
+{
+	int idx = GetSmartIdIndex(sid);
+	if (idx >= m_entityClasses.size())
+	{
+		m_entityClasses.resize(idx + 1, nullptr);
+	}
+	m_entityClasses[idx] = pEntityClass;
+}
+
+const CLogicalSystem::SEntityClass* CLogicalSystem::GetEntityClass(SmartId sid) const
+{
+	int idx = GetSmartIdIndex(sid);
+	return idx < m_entityClasses.size() ? m_entityClasses[idx] : nullptr;
+}
+
+SmartId CLogicalSystem::ReuseEntity(const SEntityClass* pEntityClass)
+{
+	CAllocationCheck::CScope allocationCheck(s_reuseAllocationCheck);
+
+	auto fnd = m_recycledEntities.find(pEntityClass);
+	if (fnd == m_recycledEntities.end() || fnd->second.empty())
+	{
+		return InvalidLink;
+	}
+
+	SmartId sid = fnd->second.back();
+	fnd->second.pop_back();
+
+	CLogicalEntity* pEntity = GetEntity(sid);
+	if (!pEntity)
+	{
+		return InvalidLink;
+	}
+
+	// The recycled entity keeps its slot, so the kinematics slot is the same
+	m_kinematics.Add(sid, pEntityClass->bGravity);
+
+	CGame::Get().GetPhysicalSystem()->RestoreEntity(pEntity->GetPhysicalEntityId());
+
+	CGame::Get().GetRenderProxy()->OnCommand<RenderCommand::SetVisibleCommand>(pEntity->GetRenderEntityId(), true);
+	pEntity->ActivateRenderSlot(0);
+
+	return sid;
+}
+
+void CLogicalSystem::RecycleEntity(CLogicalEntity* pEntity, const SEntityClass* pEntityClass)
+{
+	CAllocationCheck::CScope allocationCheck(s_recycleAllocationCheck);
+
+	m_kinematics.Remove(pEntity->GetKinematicsIdx());
+
+	// The entity gets the new SmartIds, so all the handles of the removed entity become invalid
+	SmartId sid = ReissueId(pEntity->GetId());
+
+	CPhysicalSystem* pPhysicalSystem = CGame::Get().GetPhysicalSystem();
+	SmartId physicalEntityId = pPhysicalSystem->RecycleEntity(pEntity->GetPhysicalEntityId());
+	pEntity->SetPhysics(physicalEntityId);
+	if (CPhysicalEntity* pPhysics = pPhysicalSystem->GetEntity(physicalEntityId))
+	{
+		pPhysics->SetParentEntityId(sid);
+	}
+
+	CGame::Get().GetRenderProxy()->OnCommand<RenderCommand::SetVisibleCommand>(pEntity->GetRenderEntityId(), false);
+
+	m_recycledEntities[pEntityClass].push_back(sid);
+}
+
 void CLogicalSystem::RemoveEntity(SmartId sid, bool immediate)
 {
 	if (CLogicalEntity* pEntity = GetEntity(sid))
 	{
+		const SEntityClass* pEntityClass = GetEntityClass(sid);
+		if (pEntityClass && pEntityClass->poolSize > 0)
+		{
+			// The entity is recycled with the garbage collection, so it isn't hidden
+			// and reissued in the middle of the update, while it could be still used
+			if (!immediate)
+			{
+				if (std::find(m_recycleDeferred.begin(), m_recycleDeferred.end(), sid) == m_recycleDeferred.end())
+				{
+					m_recycleDeferred.push_back(sid);
+				}
+				return;
+			}
+
+			if (m_recycledEntities[pEntityClass].size() < pEntityClass->poolSize)
+			{
+				RecycleEntity(pEntity, pEntityClass);
+				return;
+			}
+		}
+
 		SmartId physicalEntityId = pEntity->GetPhysicalEntityId();
 		if (physicalEntityId != InvalidLink)
 		{
@@ -107,6 +247,8 @@ void CLogicalSystem::RemoveEntity(SmartId sid, bool immediate)
 			CGame::Get().GetRenderSystem()->RemoveEntity(renderEntityId, immediate);
 		}
 
+		m_kinematics.Remove(pEntity->GetKinematicsIdx());
+
 		CEntitySystem::RemoveEntity(sid, immediate);
 	}
 }
@@ -114,11 +256,24 @@ void CLogicalSystem::RemoveEntity(SmartId sid, bool immediate)
 void CLogicalSystem::CollectGarbage()
 {
 	m_pActorSystem->CollectGarbage();
+
+	// The entities are removed or recycled, if the pool of their class isn't full
+	for (SmartId sid : m_recycleDeferred)
+	{
+		RemoveEntity(sid, true);
+	}
+	m_recycleDeferred.clear();
+
 	CEntitySystem::CollectGarbage();
 }
 
 void CLogicalSystem::Clear()
 {
 	m_pActorSystem->Release();
+	m_pBulletSystem->Clear();
+	m_timers.Clear();
+	m_kinematics.Clear();
+	m_recycledEntities.clear();
+	m_recycleDeferred.clear();
 	CEntitySystem::Clear();
 }
\ No newline at end of file
@@ -1,18 +1,26 @@
 #pragma once
 
 #include "LogicalEntity.h"
+#include "TimerWheel.h"
+#include "ConfigurationSystem/EntityConfiguration.h"
 
 #include <string>
 #include <memory>
+#include <vector>
+#include <unordered_map>
 
 class CActorSystem;
 class CLevelSystem;
 class CFeedbackSystem;
+class CBulletSystem;
 
 /**
  * @class CLogicalSystem
  * System which contains all the logical entities and some of the game subsystems.
  * Provides functions to create, remove and process the logical entities.
+ * The removed entities of the classes with the pool size (see CEntityConfiguration)
+ * are recycled together with their physical and render entities: they are
+ * hidden and kept until the new entity of the same class is created.
  */
 class CLogicalSystem : public CEntitySystem<CLogicalEntity, false>
 {
@@ -24,6 +32,7 @@ public:
 	/**
 	 * @function CreateEntityFromClass
 	 * Create entity from the specified configuration (see CEntityConfiguration).
+	 * The recycled entity of the class is reused, if there is any.
 	 * 
 	 * @param name - entity configuration's name to create
 	 */
@@ -33,6 +42,7 @@ public:
 	 * @function RemoveEntity
 	 * Remove the entity with the specified SmartId. Overrides the CEntitySystem
 	 * method to remove the owner physical and render entities as well.
+	 * The entities of the pooled classes are recycled immediately or with the garbage collection.
 	 * 
 	 * @param sid - SmartId of the entity to remove.
 	 * @immediate - "physical" delete the entity from the container immediately.
@@ -42,7 +52,7 @@ public:
 	/**
 	 * @function CollectGarbage
 	 * Override of the CEntitySystem method. Also initiates the CActorSystem's
-	 * garbage collection.
+	 * garbage collection and recycles the removed entities of the pooled classes.
 	 */
 	virtual void CollectGarbage() override;
 
@@ -55,22 +65,81 @@ public:
 	/**
 	 * @function Update
 	 * Function to update all the logical entities' states. Also updates all the logical
-	 * subsystems. Should be called each frame.
+	 * subsystems and expires the due timers. Should be called each frame.
 	 *
 	 * @param dt - delta time since the last function call.
 	 */
 	void Update(sf::Time dt);
 
+	/**
+	 * @function FlushTransforms
+	 * Send the transforms of the entities changed since the last flush
+	 * to their physical and render entities, once per entity.
+	 * The update flushes the integrated transforms before the bullets collide,
+	 * this call should still be made each frame after the update, even if the game is paused.
+	 */
+	void FlushTransforms();
+
+	/**
+	 * @function Render
+	 * Send the bullets to the render, since they have no render entities.
+	 * Should be called once per frame after the last flush.
+	 *
+	 * @param fLag - time in seconds the render lags behind the last simulation tick.
+	 */
+	void Render(float fLag);
+
+	struct SStatistics
+	{
+		int numFlushes = 0;
+		// The transform changes merged into the already pending flushes
+		int numCoalescedUpdates = 0;
+		// The entities of the pooled classes created from the recycled ones and from scratch
+		int numPoolHits = 0;
+		int numPoolMisses = 0;
+		// The timers expired during the last update
+		int numExpiredTimers = 0;
+	};
+
+	const SStatistics& GetStatistics() const { return m_statistics; }
+
 	// Release the logical subsystems in the proper order
 	void Release();
 
 	CActorSystem* GetActorSystem() { return m_pActorSystem.get(); }
 	CLevelSystem* GetLevelSystem() { return m_pLevelSystem.get(); }
 	CFeedbackSystem* GetFeedbackSystem() { return m_pFeedbackSystem.get(); }
+	CBulletSystem* GetBulletSystem() { return m_pBulletSystem.get(); }
+	CTimerWheel* GetTimers() { return &m_timers; }
 
 private:
 
+	using SEntityClass = CEntityConfiguration::SEntityClass;
+
+	// Gather the holes and pull the entities and the bullets of the classes affected by the gravity
+	void ApplyGravity(float dt);
+
+	void SetEntityClass(SmartId sid, const SEntityClass* pEntityClass);
+	const SEntityClass* GetEntityClass(SmartId sid) const;
+
+	SmartId ReuseEntity(const SEntityClass* pEntityClass);
+	void RecycleEntity(CLogicalEntity* pEntity, const SEntityClass* pEntityClass);
+
+private:
+
+	CKinematics m_kinematics;
+	CGravity m_gravity;
+	CTimerWheel m_timers;
+	SStatistics m_statistics;
+
+	// Classes of the entities indexed by the link indices of their SmartIds
+	std::vector<const SEntityClass*> m_entityClasses;
+	std::unordered_map<const SEntityClass*, std::vector<SmartId>> m_recycledEntities;
+	// The removed entities of the pooled classes waiting for the garbage collection
+	std::vector<SmartId> m_recycleDeferred;
+
 	std::unique_ptr<CActorSystem> m_pActorSystem;
 	std::unique_ptr<CLevelSystem> m_pLevelSystem;
 	std::unique_ptr<CFeedbackSystem> m_pFeedbackSystem;
+	std::unique_ptr<CBulletSystem> m_pBulletSystem;
 };
\ No newline at end of file
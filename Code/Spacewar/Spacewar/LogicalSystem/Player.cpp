@@ -4,10 +4,14 @@
 #include "LogicalSystem.h"
 #include "ActorSystem.h"
 #include "LevelSystem.h"
-#include "Projectile.h"
+#include "BulletSystem.h"
 #include "FeedbackSystem.h"
 #include "ConfigurationSystem/ConfigurationSystem.h"
 #include "PhysicalSystem/PhysicalEntity.h"
+#include "AllocationCounter.h"
+
+// The shots are fired often, the bullets and the timers are reused after the warm-up
+static CAllocationCheck s_shotAllocationCheck("CPlayer::Shoot", 256, 256);
 
 CPlayer::CPlayer(const std::string& configName, const CPlayerConfiguration::SPlayerConfiguration* pConfig)
 	: CActor(pConfig->entityName), m_configName(configName), m_pConfig(pConfig)
@@ -18,11 +22,16 @@ CPlayer::CPlayer(const std::string& configName, const CPlayerConfiguration::SPla
 		m_ammoCount = m_pConfig->ammoCount;
 		m_fFuel = m_pConfig->fFuel;
 	}
+	m_burstTimer = CGame::Get().GetLogicalSystem()->GetTimers()->Schedule(0.f, this, ETimer_Burst);
 	SetNeedSerialize();
 }
 
 CPlayer::~CPlayer()
 {
+	CTimerWheel* pTimers = CGame::Get().GetLogicalSystem()->GetTimers();
+	pTimers->Cancel(m_shotTimer);
+	pTimers->Cancel(m_burstTimer);
+
 	if (m_pController)
 	{
 		m_pController->UnregisterEventListener(this);
@@ -154,27 +163,28 @@ void CPlayer::OnControllerEvent(EControllerEvent evt)
 	}
 }
 
-void CPlayer::OnCollision(SmartId sid)
+void CPlayer::OnCollisionBegin(SmartId sid)
 {
 	if (CActor* pActor = CGame::Get().GetLogicalSystem()->GetActorSystem()->GetActor(sid))
 	{
-		if (pActor->GetType() == EActorType_Projectile)
+		if (pActor->GetType() == EActorType_Hole)
 		{
-			SmartId ownerId = static_cast<CProjectile*>(pActor)->GetOwnerId();
-			if (ownerId != m_entityId)
-			{
-				CGame::Get().GetLogicalSystem()->GetFeedbackSystem()->OnEvent(m_entityId, m_pConfig->feedbackSchema, CFeedbackConfiguration::Death);
-				Destroy();
-
-				if (CPlayer* pOwner = static_cast<CPlayer*>(CGame::Get().GetLogicalSystem()->GetActorSystem()->GetActor(ownerId)))
-				{
-					pOwner->SetScore(pOwner->GetScore() + 1);
-				}
-			}
+			SetNeedSerialize();
 		}
-		else if (pActor->GetType() == EActorType_Hole)
+	}
+}
+
+void CPlayer::OnBulletHit(SmartId ownerId)
+{
+	if (ownerId != m_entityId)
+	{
+		CGame::Get().GetLogicalSystem()->GetFeedbackSystem()->OnEvent(m_entityId, m_pConfig->feedbackSchema, CFeedbackConfiguration::Death);
+		Destroy();
+
+		CActor* pOwner = CGame::Get().GetLogicalSystem()->GetActorSystem()->GetActor(ownerId);
+		if (pOwner && pOwner->GetType() == EActorType_Player)
 		{
-			SetNeedSerialize();
+			static_cast<CPlayer*>(pOwner)->SetScore(static_cast<CPlayer*>(pOwner)->GetScore() + 1);
 		}
 	}
 }
@@ -202,21 +212,18 @@ void CPlayer::Update(sf::Time dt)
 		}
 	}
 
-	m_fShotsCooldown -= dt.asSeconds();
-	m_fBurstCooldown -= dt.asSeconds();
-
-	if (CGame::Get().IsServer() || !CGame::Get().GetLogicalSystem()->GetLevelSystem()->IsInGame())
+	if (m_bShooting && CanShoot())
 	{
-		if (m_fBurstCooldown <= 0.f)
-		{
-			m_shotsInBurst = m_pConfig->numShotsInBurst;
-			SetNeedSerialize();
-		}
+		Shoot();
 	}
+}
 
-	if (m_bShooting && CanShoot())
+void CPlayer::OnTimer(int tag)
+{
+	if (tag == ETimer_Burst && (CGame::Get().IsServer() || !CGame::Get().GetLogicalSystem()->GetLevelSystem()->IsInGame()))
 	{
-		Shoot();
+		m_shotsInBurst = m_pConfig->numShotsInBurst;
+		SetNeedSerialize();
 	}
 }
 
@@ -244,7 +251,7 @@ void CPlayer::Serialize(sf::Packet& packet, uint8_t mode, uint16_t& size)
 
 bool CPlayer::CanShoot() const
 {
-	return m_shotsInBurst > 0 && m_fShotsCooldown <= 0.f && m_ammoCount != 0;
+	return m_shotsInBurst > 0 && !CGame::Get().GetLogicalSystem()->GetTimers()->IsScheduled(m_shotTimer) && m_ammoCount != 0;
 }
 
 void CPlayer::Shoot()
@@ -254,28 +261,23 @@ void CPlayer::Shoot()
 		return;
 	}
 
-	CActorSystem* pActorSystem = CGame::Get().GetLogicalSystem()->GetActorSystem();
-	SmartId projectileId = pActorSystem->CreateActor<CProjectile>(m_pConfig->projectileEntityName);
+	CAllocationCheck::CScope allocationCheck(s_shotAllocationCheck);
 
-	if (CProjectile* pProjectile = static_cast<CProjectile*>(pActorSystem->GetActor(projectileId)))
-	{
-		CLogicalEntity* pEntity = GetEntity();
+	CLogicalEntity* pEntity = GetEntity();
+	CGame::Get().GetLogicalSystem()->GetBulletSystem()->Spawn(m_pConfig->projectileEntityName, m_entityId,
+		pEntity->GetTransform().transformPoint(m_pConfig->vShootHelper), pEntity->GetRotation(),
+		pEntity->GetForwardDirection() * m_pConfig->fProjSpeed, m_pConfig->fProjectileLifetime);
 
-		pProjectile->SetLifetime(m_pConfig->fProjectileLifetime);
-		pProjectile->SetOwnerId(m_entityId);
+	--m_shotsInBurst;
 
-		if (CLogicalEntity* pProjectileEntity = pProjectile->GetEntity())
-		{
-			pProjectileEntity->SetPosition(pEntity->GetTransform().transformPoint(m_pConfig->vShootHelper));
-			pProjectileEntity->SetRotation(pEntity->GetRotation());
-			pProjectileEntity->SetVelocity(pEntity->GetForwardDirection() * m_pConfig->fProjSpeed);
-		}
+	CTimerWheel* pTimers = CGame::Get().GetLogicalSystem()->GetTimers();
+	pTimers->Cancel(m_burstTimer);
+	m_burstTimer = pTimers->Schedule(m_pConfig->fBurstCooldown, this, ETimer_Burst);
+	if (m_pConfig->fShootCooldown > 0.f)
+	{
+		m_shotTimer = pTimers->Schedule(m_pConfig->fShootCooldown, this, ETimer_Shot);
 	}
 
-	--m_shotsInBurst;
-	m_fShotsCooldown = m_pConfig->fShootCooldown;
-	m_fBurstCooldown = m_pConfig->fBurstCooldown;
-
 	if (m_ammoCount > 0)
 	{
 		--m_ammoCount;
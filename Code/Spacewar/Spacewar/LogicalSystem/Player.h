@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Actor.h"
+#include "TimerWheel.h"
 #include "Controllers/Controller.h"
 #include "ConfigurationSystem/PlayerConfiguration.h"
 
@@ -15,7 +16,7 @@
  * Generally, the player can accelerate, rotate and shoot. Some of these
  * actions require specific logic like ammos or fuel. This class describes all the players' logic.
  */
-class CPlayer : public CActor, public IControllerEventListener
+class CPlayer final : public CActor, public IControllerEventListener, public ITimerListener
 {
 public:
 
@@ -41,15 +42,27 @@ public:
 	virtual void OnControllerEvent(EControllerEvent evt) override;
 
 	/**
-	 * @function OnCollision
+	 * @function OnCollisionBegin
 	 * Inherited function to handle the collisions.
 	 * 
 	 * @param sid - SmartId of the logical entity which are the player collided with.
 	 */
-	virtual void OnCollision(SmartId sid) override;
+	virtual void OnCollisionBegin(SmartId sid) override;
+
+	/**
+	 * @function OnBulletHit
+	 * Inherited function to handle the bullets' hits. The player is destroyed
+	 * and the owner of the bullet gets the score.
+	 * 
+	 * @param ownerId - SmartId of the player which shot the bullet.
+	 */
+	virtual void OnBulletHit(SmartId ownerId) override;
 	virtual EActorType GetType() const override { return EActorType_Player; }
 	virtual void Update(sf::Time dt) override;
 
+	// The burst is restored on the burst cooldown's expiration
+	virtual void OnTimer(int tag) override;
+
 	/**
 	 * @function Serialize
 	 * Serialize the current player's state to replicate it on the client side.
@@ -92,9 +105,15 @@ private:
 	
 	bool m_bShooting = false;
 	
+	enum ETimer
+	{
+		ETimer_Shot,
+		ETimer_Burst,
+	};
+
 	int m_shotsInBurst = 0;
-	float m_fBurstCooldown = 0.f;
-	float m_fShotsCooldown = 0.f;
+	SmartId m_shotTimer = InvalidLink;
+	SmartId m_burstTimer = InvalidLink;
 
 	int m_ammoCount = -1;
 	float m_fFuel = -1.f;
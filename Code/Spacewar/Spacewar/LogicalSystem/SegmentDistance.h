@@ -0,0 +1,72 @@
+#pragma once
+
+#include <algorithm>
+#include <cfloat>
+
+/**
+ * The distance kernels of the bullets' collisions (see CBulletSystem::Collide).
+ * Kept apart from the bullet system, so the benchmark runs the same code.
+ */
+
+// The SSE2 kernel can be disabled with SPACEWAR_NO_SIMD in the same way as the kinematics' one
+#if !defined(SPACEWAR_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define BULLETS_SSE
+#include <emmintrin.h>
+#endif
+
+// Capsule vs capsule is the distance between the axes' segments (see Real-Time Collision Detection, 5.1.9).
+// The closest point on the bullet's axis is found for the lines, then the closest point on the target's
+// axis for it and the bullet's one again, so both points are clamped to the segments without branches.
+inline float SegmentsDistanceSq(float ax, float ay, float bx, float by, float p2x, float p2y, float d2x, float d2y, float e)
+{
+	float d1x = bx - ax;
+	float d1y = by - ay;
+	float rx = ax - p2x;
+	float ry = ay - p2y;
+
+	float a = std::max(d1x * d1x + d1y * d1y, FLT_MIN);
+	float b = d1x * d2x + d1y * d2y;
+	float c = d1x * rx + d1y * ry;
+	float f = d2x * rx + d2y * ry;
+	float denom = std::max(a * e - b * b, FLT_MIN);
+
+	float s = std::min(std::max((b * f - c * e) / denom, 0.f), 1.f);
+	float u = std::min(std::max((b * s + f) / e, 0.f), 1.f);
+	s = std::min(std::max((b * u - c) / a, 0.f), 1.f);
+
+	float dx = rx + d1x * s - d2x * u;
+	float dy = ry + d1y * s - d2y * u;
+	return dx * dx + dy * dy;
+}
+
+#ifdef BULLETS_SSE
+inline __m128 Clamp01(__m128 v)
+{
+	return _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), _mm_set1_ps(1.f));
+}
+
+// The same as SegmentsDistanceSq for the four bullets' axes
+inline __m128 SegmentsDistanceSq(__m128 ax, __m128 ay, __m128 bx, __m128 by, __m128 p2x, __m128 p2y, __m128 d2x, __m128 d2y, __m128 e)
+{
+	const __m128 vMin = _mm_set1_ps(FLT_MIN);
+
+	__m128 d1x = _mm_sub_ps(bx, ax);
+	__m128 d1y = _mm_sub_ps(by, ay);
+	__m128 rx = _mm_sub_ps(ax, p2x);
+	__m128 ry = _mm_sub_ps(ay, p2y);
+
+	__m128 a = _mm_max_ps(_mm_add_ps(_mm_mul_ps(d1x, d1x), _mm_mul_ps(d1y, d1y)), vMin);
+	__m128 b = _mm_add_ps(_mm_mul_ps(d1x, d2x), _mm_mul_ps(d1y, d2y));
+	__m128 c = _mm_add_ps(_mm_mul_ps(d1x, rx), _mm_mul_ps(d1y, ry));
+	__m128 f = _mm_add_ps(_mm_mul_ps(d2x, rx), _mm_mul_ps(d2y, ry));
+	__m128 denom = _mm_max_ps(_mm_sub_ps(_mm_mul_ps(a, e), _mm_mul_ps(b, b)), vMin);
+
+	__m128 s = Clamp01(_mm_div_ps(_mm_sub_ps(_mm_mul_ps(b, f), _mm_mul_ps(c, e)), denom));
+	__m128 u = Clamp01(_mm_div_ps(_mm_add_ps(_mm_mul_ps(b, s), f), e));
+	s = Clamp01(_mm_div_ps(_mm_sub_ps(_mm_mul_ps(b, u), c), a));
+
+	__m128 dx = _mm_sub_ps(_mm_add_ps(rx, _mm_mul_ps(d1x, s)), _mm_mul_ps(d2x, u));
+	__m128 dy = _mm_sub_ps(_mm_add_ps(ry, _mm_mul_ps(d1y, s)), _mm_mul_ps(d2y, u));
+	return _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+}
+#endif
\ No newline at end of file
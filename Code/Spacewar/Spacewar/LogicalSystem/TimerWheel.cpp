@@ -0,0 +1,195 @@
+#include "StdAfx.h"
+#include "TimerWheel.h"
+
+#include <cmath>
+#include <algorithm>
+
+CTimerWheel::CTimerWheel()
+	: m_timers(NumHeads)
+{
+	for (int i = 0; i < NumHeads; ++i)
+	{
+		m_timers[i].prev = m_timers[i].next = i;
+	}
+}
+
+int CTimerWheel::Find(SmartId sid) const
+{
+	int idx = GetSmartIdIndex(sid) + NumHeads;
+	if (sid >= 0 && idx < (int)m_timers.size() && m_timers[idx].bActive && m_timers[idx].generation == GetSmartIdGeneration(sid))
+	{
+		return idx;
+	}
+	return InvalidLink;
+}
+
+void CTimerWheel::Link(int idx, int head)
+{
+	STimer& timer = m_timers[idx];
+	timer.prev = m_timers[head].prev;
+	timer.next = head;
+	m_timers[timer.prev].next = idx;
+	m_timers[head].prev = idx;
+}
+
+void CTimerWheel::Unlink(int idx)
+{
+	STimer& timer = m_timers[idx];
+	m_timers[timer.prev].next = timer.next;
+	m_timers[timer.next].prev = timer.prev;
+	timer.prev = timer.next = idx;
+}
+
+void CTimerWheel::Insert(int idx)
+{
+	// The timers cascaded to the current tick get into it's slot, which is processed after the cascades
+	uint32_t delta = std::max(m_timers[idx].expiry - m_currentTick, 1u);
+
+	int level = 0;
+	while (level < NumLevels - 1 && delta >= (1u << (SlotBits * (level + 1))))
+	{
+		++level;
+	}
+
+	int slot = (m_timers[idx].expiry >> (SlotBits * level)) & (NumSlots - 1);
+	Link(idx, level * NumSlots + slot);
+}
+
+void CTimerWheel::Release(int idx)
+{
+	STimer& timer = m_timers[idx];
+	timer.bActive = false;
+	timer.pListener = nullptr;
+	timer.generation = (timer.generation + 1) & SmartIdGenerationMask;
+	timer.next = m_dFirstFree;
+	m_dFirstFree = idx;
+	--m_dNumTimers;
+}
+
+SmartId CTimerWheel::Schedule(float fDelay, ITimerListener* pListener, int tag)
+{
+	int idx = m_dFirstFree;
+	if (idx != InvalidLink)
+	{
+		m_dFirstFree = m_timers[idx].next;
+	}
+	else
+	{
+		idx = (int)m_timers.size();
+		m_timers.emplace_back();
+	}
+
+	// The delay is counted from the current time, not from the start of the current tick,
+	// the current tick's slot is already processed, so the timer expires on the next tick at least
+	constexpr float MaxTicks = (float)(1u << (SlotBits * NumLevels)) - 1.f;
+	float fTicks = std::clamp(ceilf((m_fTickTime + fDelay) / TickDuration), 1.f, MaxTicks);
+
+	STimer& timer = m_timers[idx];
+	timer.expiry = m_currentTick + (uint32_t)fTicks;
+	timer.pListener = pListener;
+	timer.tag = tag;
+	timer.bActive = true;
+	++m_dNumTimers;
+
+	Insert(idx);
+	return MakeSmartId(idx - NumHeads, timer.generation);
+}
+
+void CTimerWheel::Cancel(SmartId sid)
+{
+	int idx = Find(sid);
+	if (idx != InvalidLink)
+	{
+		Unlink(idx);
+		Release(idx);
+	}
+}
+
+bool CTimerWheel::IsScheduled(SmartId sid) const
+{
+	return Find(sid) != InvalidLink;
+}
+
+void CTimerWheel::Cascade(int level)
+{
+	int head = level * NumSlots + ((m_currentTick >> (SlotBits * level)) & (NumSlots - 1));
+	while (m_timers[head].next != head)
+	{
+		int idx = m_timers[head].next;
+		Unlink(idx);
+		Insert(idx);
+	}
+}
+
+void CTimerWheel::Tick()
+{
+	++m_currentTick;
+
+	// The higher levels are cascaded first, so their timers can get into the lower slots being cascaded
+	int numCascades = 0;
+	while (numCascades < NumLevels - 1 && (m_currentTick & ((1u << (SlotBits * (numCascades + 1))) - 1)) == 0)
+	{
+		++numCascades;
+	}
+	for (int level = numCascades; level > 0; --level)
+	{
+		Cascade(level);
+	}
+
+	// The due timers are moved into the separate list, so the listeners can cancel any of them
+	int head = m_currentTick & (NumSlots - 1);
+	while (m_timers[head].next != head)
+	{
+		int idx = m_timers[head].next;
+		Unlink(idx);
+		Link(idx, ExpiringHead);
+	}
+
+	while (m_timers[ExpiringHead].next != ExpiringHead)
+	{
+		int idx = m_timers[ExpiringHead].next;
+		ITimerListener* pListener = m_timers[idx].pListener;
+		int tag = m_timers[idx].tag;
+
+		Unlink(idx);
+		Release(idx);
+		++m_dNumExpired;
+
+		if (pListener)
+		{
+			pListener->OnTimer(tag);
+		}
+	}
+}
+
+void CTimerWheel::Advance(float dt)
+{
+	m_dNumExpired = 0;
+	m_fTickTime += dt;
+
+	int numTicks = (int)(m_fTickTime / TickDuration);
+	m_fTickTime -= numTicks * TickDuration;
+
+	for (int i = 0; i < numTicks; ++i)
+	{
+		if (m_dNumTimers == 0)
+		{
+			// Nothing to expire, so the wheel is just turned to the current tick
+			m_currentTick += numTicks - i;
+			break;
+		}
+		Tick();
+	}
+}
+
+void CTimerWheel::Clear()
+{
+	for (int idx = NumHeads; idx < (int)m_timers.size(); ++idx)
+	{
+		if (m_timers[idx].bActive)
+		{
+			Unlink(idx);
+			Release(idx);
+		}
+	}
+}
\ No newline at end of file
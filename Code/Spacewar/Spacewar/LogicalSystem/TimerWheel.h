@@ -0,0 +1,123 @@
+#pragma once
+
+#include "EntitySystem.h"
+
+#include <vector>
+#include <cstdint>
+
+/**
+ * @interface ITimerListener
+ * Interface to receive the expirations of the timers (see CTimerWheel).
+ */
+class ITimerListener
+{
+public:
+
+	virtual ~ITimerListener() = default;
+
+	/**
+	 * @function OnTimer
+	 * Called when the timer expires. The timer is already released,
+	 * so the listener can schedule the new one from here.
+	 *
+	 * @param tag - the value passed on the timer's scheduling.
+	 */
+	virtual void OnTimer(int tag) = 0;
+};
+
+/**
+ * @class CTimerWheel
+ * Hierarchical timer wheel for the lifetimes and the cooldowns of the game objects.
+ * The time is divided into the ticks. Each level of the wheel is the ring of the slots,
+ * the slot of the first level holds the timers expiring at the same tick, the slot
+ * of each next level covers the whole ring of the previous one. The timers are moved
+ * to the lower levels, when the current tick reaches the range of their slot,
+ * so only the timers, which are actually due, are processed each tick.
+ * Scheduling and cancelling the timers are constant time operations.
+ * The timers are identified by the SmartIds, which become invalid after the timer's expiration.
+ */
+class CTimerWheel
+{
+public:
+
+	static constexpr float TickDuration = 1.f / 128.f;
+
+	CTimerWheel();
+	CTimerWheel(const CTimerWheel&) = delete;
+
+	/**
+	 * @function Schedule
+	 * Schedule the timer. The timer never expires earlier than the specified delay,
+	 * but can be late for less than a tick. The delay is limited by the wheel's range.
+	 *
+	 * @param fDelay - delay in seconds.
+	 * @param pListener - listener to be notified on the expiration.
+	 * @param tag - value to be passed into the listener.
+	 * @return SmartId of the timer.
+	 */
+	SmartId Schedule(float fDelay, ITimerListener* pListener, int tag = 0);
+
+	// Cancel the timer, if it's not expired yet
+	void Cancel(SmartId sid);
+
+	bool IsScheduled(SmartId sid) const;
+
+	/**
+	 * @function Advance
+	 * Advance the time of the wheel and notify the listeners of the expired timers.
+	 *
+	 * @param dt - delta time in seconds.
+	 */
+	void Advance(float dt);
+
+	// Cancel all the timers
+	void Clear();
+
+	int GetNumTimers() const { return m_dNumTimers; }
+
+	// The number of the timers expired during the last Advance call
+	int GetNumExpired() const { return m_dNumExpired; }
+
+private:
+
+	static constexpr int SlotBits = 6;
+	static constexpr int NumSlots = 1 << SlotBits;
+	static constexpr int NumLevels = 4;
+
+	// The first nodes are the heads of the slots' lists and the expiring timers' list
+	static constexpr int NumHeads = NumLevels * NumSlots + 1;
+	static constexpr int ExpiringHead = NumLevels * NumSlots;
+
+	struct STimer
+	{
+		uint32_t expiry = 0;
+		ITimerListener* pListener = nullptr;
+		int tag = 0;
+		// Circular list of the slot, the next free timer if it's released
+		int prev = InvalidLink;
+		int next = InvalidLink;
+		int generation = 0;
+		bool bActive = false;
+	};
+
+	int Find(SmartId sid) const;
+
+	void Insert(int idx);
+	void Link(int idx, int head);
+	void Unlink(int idx);
+	void Release(int idx);
+
+	// Move all the timers of the slot to the lower levels
+	void Cascade(int level);
+	void Tick();
+
+private:
+
+	std::vector<STimer> m_timers;
+	int m_dFirstFree = InvalidLink;
+	int m_dNumTimers = 0;
+	int m_dNumExpired = 0;
+
+	uint32_t m_currentTick = 0;
+	float m_fTickTime = 0.f; // the time passed since the current tick
+};
\ No newline at end of file
@@ -14,6 +14,11 @@ namespace MathHelpers
 		return v1.x * v2.x + v1.y * v2.y;
 	}
 
+	inline float CrossProd(const sf::Vector2f& v1, const sf::Vector2f& v2)
+	{
+		return v1.x * v2.y - v1.y * v2.x;
+	}
+
 	inline float GetLength(const sf::Vector2f& v)
 	{
 		return sqrtf(DotProd(v, v));
@@ -4,6 +4,7 @@
 #include "LogicalSystem/LogicalSystem.h"
 #include "LogicalSystem/LevelSystem.h"
 #include "LogicalSystem/ActorSystem.h"
+#include "LogicalSystem/BulletSystem.h"
 
 CNetworkController::~CNetworkController()
 {
@@ -200,6 +201,21 @@ void CNetworkProxy::SendCreateActor(SmartId sid, EActorType type, const std::str
 	BroadcastServerMessage<ServerMessage::SCreateActorMessage>(sid, type, config);
 }
 
+void CNetworkProxy::SpawnBullet(const ServerMessage::SSpawnBulletMessage& msg)
+{
+	CGame::Get().GetLogicalSystem()->GetBulletSystem()->Spawn(msg.entityClass, GetLocalEntityId(msg.owner), msg.vPos, msg.fRot, msg.vVel, msg.fLifetime);
+}
+
+void CNetworkProxy::SendSpawnBullet(const std::string& entityClass, SmartId owner, const sf::Vector2f& vPos, float fRot, const sf::Vector2f& vVel, float fLifetime)
+{
+	if (!CGame::Get().IsServer() || !CGame::Get().GetLogicalSystem()->GetLevelSystem()->IsInGame())
+	{
+		return;
+	}
+
+	BroadcastServerMessage<ServerMessage::SSpawnBulletMessage>(entityClass, owner, vPos, fRot, vVel, fLifetime);
+}
+
 void ServerMessage::SConnectMessage::OnReceive() const
 {
 	if (result == EConnectionResult_Success)
@@ -284,6 +300,16 @@ void ServerMessage::SSetPauseMessage::OnReceive() const
 	CGame::Get().Pause(bPause);
 }
 
+void ServerMessage::SSpawnBulletMessage::OnReceive() const
+{
+	CGame::Get().GetNetworkProxy()->SpawnBullet(*this);
+}
+
+void ServerMessage::SRemoveBulletsMessage::OnReceive() const
+{
+	CGame::Get().GetLogicalSystem()->GetBulletSystem()->RemoveBullets();
+}
+
 void CNetworkProxy::OnSerializationReceived(sf::Packet& packet)
 {
 	CGame::Get().GetLogicalSystem()->GetActorSystem()->Serialize(packet, true);
@@ -427,5 +453,19 @@ void CNetworkProxy::OnServerMessageReceived(sf::Packet& packet)
 		body.OnReceive();
 	}
 	break;
+	case ServerMessage::EServerMessage_SpawnBullet:
+	{
+		ServerMessage::SSpawnBulletMessage body;
+		packet >> body;
+		body.OnReceive();
+	}
+	break;
+	case ServerMessage::EServerMessage_RemoveBullets:
+	{
+		ServerMessage::SRemoveBulletsMessage body;
+		packet >> body;
+		body.OnReceive();
+	}
+	break;
 	}
 }
\ No newline at end of file
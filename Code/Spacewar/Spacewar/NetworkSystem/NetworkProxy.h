@@ -106,6 +106,8 @@ namespace ServerMessage
 		EServerMessage_LocalPlayer,
 		EServerMessage_StartLevel,
 		EServerMessage_SetPause,
+		EServerMessage_SpawnBullet,
+		EServerMessage_RemoveBullets,
 	};
 
 	struct SServerMessage
@@ -184,6 +186,29 @@ namespace ServerMessage
 
 		bool bPause = false;
 	};
+
+	struct SSpawnBulletMessage : public SServerMessage
+	{
+		static constexpr EServerMessage GetType() { return EServerMessage_SpawnBullet; }
+		virtual void OnReceive() const override;
+
+		SSpawnBulletMessage() = default;
+		SSpawnBulletMessage(const std::string& _entityClass, SmartId _owner, const sf::Vector2f& _vPos, float _fRot, const sf::Vector2f& _vVel, float _fLifetime)
+			: entityClass(_entityClass), owner(_owner), vPos(_vPos), fRot(_fRot), vVel(_vVel), fLifetime(_fLifetime) {}
+
+		std::string entityClass;
+		int32_t owner = InvalidLink;
+		sf::Vector2f vPos;
+		float fRot = 0.f;
+		sf::Vector2f vVel;
+		float fLifetime = 0.f;
+	};
+
+	struct SRemoveBulletsMessage : public SServerMessage
+	{
+		static constexpr EServerMessage GetType() { return EServerMessage_RemoveBullets; }
+		virtual void OnReceive() const override;
+	};
 }
 
 inline sf::Packet& operator<<(sf::Packet& packet, ClientMessage::SChangePlayerPresetMessage& msg)
@@ -281,6 +306,26 @@ inline sf::Packet& operator>>(sf::Packet& packet, sf::Vector2f& vec)
 	return packet >> vec.x >> vec.y;
 }
 
+inline sf::Packet& operator<<(sf::Packet& packet, ServerMessage::SSpawnBulletMessage& msg)
+{
+	return packet << msg.entityClass << msg.owner << msg.vPos << msg.fRot << msg.vVel << msg.fLifetime;
+}
+
+inline sf::Packet& operator>>(sf::Packet& packet, ServerMessage::SSpawnBulletMessage& msg)
+{
+	return packet >> msg.entityClass >> msg.owner >> msg.vPos >> msg.fRot >> msg.vVel >> msg.fLifetime;
+}
+
+inline sf::Packet& operator<<(sf::Packet& packet, ServerMessage::SRemoveBulletsMessage& msg)
+{
+	return packet;
+}
+
+inline sf::Packet& operator>>(sf::Packet& packet, ServerMessage::SRemoveBulletsMessage& msg)
+{
+	return packet;
+}
+
 enum ESerializationMode : uint8_t
 {
 	ESerializationMode_Read,
@@ -443,6 +488,8 @@ public:
 	void RemoveActor(SmartId sid);
 	void StartLevel(const std::string& level);
 	void SendCreateActor(SmartId sid, EActorType type, const std::string& config, const CPlayerConfiguration::SPlayerConfiguration* pConfig = nullptr);
+	void SpawnBullet(const ServerMessage::SSpawnBulletMessage& msg);
+	void SendSpawnBullet(const std::string& entityClass, SmartId owner, const sf::Vector2f& vPos, float fRot, const sf::Vector2f& vVel, float fLifetime);
 
 private:
 
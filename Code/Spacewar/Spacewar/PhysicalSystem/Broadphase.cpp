@@ -0,0 +1,167 @@
+#include "StdAfx.h"
+#include "Broadphase.h"
+
+void CBruteForceBroadphase::AddProxy(SmartId sid, const sf::FloatRect& bounds, const SCollisionFilter& filter)
+{
+	auto fnd = std::lower_bound(m_proxies.begin(), m_proxies.end(), sid);
+	if (fnd == m_proxies.end() || fnd->sid != sid)
+	{
+		m_proxies.insert(fnd, SProxy{ sid, bounds, filter });
+	}
+}
+
+void CBruteForceBroadphase::UpdateProxy(SmartId sid, const sf::FloatRect& bounds)
+{
+	auto fnd = std::lower_bound(m_proxies.begin(), m_proxies.end(), sid);
+	if (fnd != m_proxies.end() && fnd->sid == sid)
+	{
+		fnd->bounds = bounds;
+	}
+}
+
+void CBruteForceBroadphase::RemoveProxy(SmartId sid)
+{
+	auto fnd = std::lower_bound(m_proxies.begin(), m_proxies.end(), sid);
+	if (fnd != m_proxies.end() && fnd->sid == sid)
+	{
+		m_proxies.erase(fnd);
+	}
+}
+
+void CBruteForceBroadphase::CollectPairs(std::vector<std::pair<SmartId, SmartId>>& pairs)
+{
+	pairs.clear();
+
+	for (int i = 0; i < m_proxies.size(); ++i)
+	{
+		for (int j = i + 1; j < m_proxies.size(); ++j)
+		{
+			if (m_proxies[i].filter.Accepts(m_proxies[j].filter))
+			{
+				pairs.emplace_back(m_proxies[i].sid, m_proxies[j].sid);
+			}
+		}
+	}
+}
+
+void CBruteForceBroadphase::Query(const sf::FloatRect& bounds, std::vector<SmartId>& results)
+{
+	for (const auto& proxy : m_proxies)
+	{
+		if (Overlap(proxy.bounds, bounds))
+		{
+			results.push_back(proxy.sid);
+		}
+	}
+}
+
+void CGridBroadphase::AddProxy(SmartId sid, const sf::FloatRect& bounds, const SCollisionFilter& filter)
+{
+	if (sid < 0)
+	{
+		return;
+	}
+
+	int idx = GetSmartIdIndex(sid);
+	if (idx >= m_proxies.size())
+	{
+		m_proxies.resize(idx + 1);
+	}
+	m_proxies[idx].sid = sid;
+	m_proxies[idx].bounds = bounds;
+	m_proxies[idx].filter = filter;
+	m_proxies[idx].bValid = true;
+	m_bGridValid = false;
+}
+
+void CGridBroadphase::UpdateProxy(SmartId sid, const sf::FloatRect& bounds)
+{
+	if (SProxy* pProxy = GetProxy(sid))
+	{
+		pProxy->bounds = bounds;
+		m_bGridValid = false;
+	}
+}
+
+void CGridBroadphase::RemoveProxy(SmartId sid)
+{
+	if (SProxy* pProxy = GetProxy(sid))
+	{
+		pProxy->bValid = false;
+		m_bGridValid = false;
+	}
+}
+
+void CGridBroadphase::Clear()
+{
+	m_proxies.clear();
+	m_bGridValid = false;
+}
+
+void CGridBroadphase::SetLevelSize(float fLevelSize)
+{
+	if (fLevelSize != m_fLevelSize)
+	{
+		m_fLevelSize = fLevelSize;
+		m_bGridValid = false;
+	}
+}
+
+CGridBroadphase::SProxy* CGridBroadphase::GetProxy(SmartId sid)
+{
+	int idx = GetSmartIdIndex(sid);
+	if (sid >= 0 && idx < m_proxies.size() && m_proxies[idx].bValid && m_proxies[idx].sid == sid)
+	{
+		return &m_proxies[idx];
+	}
+	return nullptr;
+}
+
+void CGridBroadphase::FillGrid()
+{
+	m_grid.Reset(m_fLevelSize, m_fCellSize);
+
+	// The grid stores the whole SmartIds, so the pairs need no remapping
+	for (const SProxy& proxy : m_proxies)
+	{
+		if (proxy.bValid)
+		{
+			m_grid.Insert(proxy.sid, proxy.bounds, proxy.filter);
+		}
+	}
+
+	m_bGridValid = true;
+}
+
+void CGridBroadphase::CollectPairs(std::vector<std::pair<SmartId, SmartId>>& pairs)
+{
+	if (!m_bGridValid)
+	{
+		FillGrid();
+	}
+
+	m_grid.CollectPairs(pairs);
+}
+
+void CGridBroadphase::Query(const sf::FloatRect& bounds, std::vector<SmartId>& results)
+{
+	if (!m_bGridValid)
+	{
+		FillGrid();
+	}
+
+	size_t first = results.size();
+
+	m_grid.Query(bounds, [&](SmartId sid)
+		{
+			const SProxy* pProxy = GetProxy(sid);
+			if (pProxy && Overlap(pProxy->bounds, bounds))
+			{
+				results.push_back(sid);
+			}
+		});
+
+	// The objects overlapping several cells are met several times
+	std::sort(results.begin() + first, results.end());
+	results.erase(std::unique(results.begin() + first, results.end()), results.end());
+}
\ No newline at end of file
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "EntitySystem.h"
+#include "CollisionFilter.h"
+#include "UniformGrid.h"
+
+#include <vector>
+#include <utility>
+
+#include <SFML/Graphics/Rect.hpp>
+
+/**
+ * @interface IBroadphase
+ * Interface of the collisions' broadphase. The broadphase stores the bounding
+ * boxes (proxies) of the physical entities and quickly finds the pairs of them,
+ * which could potentially collide, so only these pairs are passed into the narrow phase.
+ * The proxies are identified by the SmartIds of the physical entities.
+ * The pairs of the proxies excluded by their collision filters are never reported.
+ */
+class IBroadphase
+{
+public:
+
+	virtual ~IBroadphase() = default;
+
+	virtual void AddProxy(SmartId sid, const sf::FloatRect& bounds, const SCollisionFilter& filter) = 0;
+	virtual void UpdateProxy(SmartId sid, const sf::FloatRect& bounds) = 0;
+	virtual void RemoveProxy(SmartId sid) = 0;
+	virtual void Clear() = 0;
+
+	// Some of the broadphases rely on the level dimensions
+	virtual void SetLevelSize(float fLevelSize) {}
+
+	/**
+	 * @function CollectPairs
+	 * Find all the potentially colliding pairs of the proxies.
+	 *
+	 * @param pairs - output pairs of the SmartIds. The first SmartId in the
+	 * pair is always less than the second one, the pairs are sorted and unique.
+	 */
+	virtual void CollectPairs(std::vector<std::pair<SmartId, SmartId>>& pairs) = 0;
+
+	/**
+	 * @function Query
+	 * Find the proxies overlapping the specified bounds.
+	 *
+	 * @param bounds - the query bounds.
+	 * @param results - SmartIds of the found proxies are appended to it, each one only once.
+	 */
+	virtual void Query(const sf::FloatRect& bounds, std::vector<SmartId>& results) = 0;
+
+protected:
+
+	static bool Overlap(const sf::FloatRect& b1, const sf::FloatRect& b2)
+	{
+		return b1.left <= b2.left + b2.width && b2.left <= b1.left + b1.width &&
+			b1.top <= b2.top + b2.height && b2.top <= b1.top + b1.height;
+	}
+};
+
+/**
+ * @class CBruteForceBroadphase
+ * The simplest broadphase considering all the pairs of the proxies as the collision candidates.
+ * Serves as the reference for the other broadphases.
+ */
+class CBruteForceBroadphase : public IBroadphase
+{
+public:
+
+	virtual void AddProxy(SmartId sid, const sf::FloatRect& bounds, const SCollisionFilter& filter) override;
+	virtual void UpdateProxy(SmartId sid, const sf::FloatRect& bounds) override;
+	virtual void RemoveProxy(SmartId sid) override;
+	virtual void Clear() override { m_proxies.clear(); }
+
+	virtual void CollectPairs(std::vector<std::pair<SmartId, SmartId>>& pairs) override;
+	virtual void Query(const sf::FloatRect& bounds, std::vector<SmartId>& results) override;
+
+private:
+
+	struct SProxy
+	{
+		SmartId sid;
+		sf::FloatRect bounds;
+		SCollisionFilter filter;
+
+		bool operator<(SmartId other) const { return sid < other; }
+	};
+
+	std::vector<SProxy> m_proxies;
+};
+
+/**
+ * @class CGridBroadphase
+ * Broadphase refilling the toroidal uniform grid (see CUniformGrid)
+ * with all the proxies each frame. The queries refill it too, if the proxies have been changed.
+ */
+class CGridBroadphase : public IBroadphase
+{
+public:
+
+	CGridBroadphase(float fCellSize) : m_fCellSize(fCellSize) {}
+
+	virtual void AddProxy(SmartId sid, const sf::FloatRect& bounds, const SCollisionFilter& filter) override;
+	virtual void UpdateProxy(SmartId sid, const sf::FloatRect& bounds) override;
+	virtual void RemoveProxy(SmartId sid) override;
+	virtual void Clear() override;
+
+	virtual void SetLevelSize(float fLevelSize) override;
+
+	virtual void CollectPairs(std::vector<std::pair<SmartId, SmartId>>& pairs) override;
+
+	virtual void Query(const sf::FloatRect& bounds, std::vector<SmartId>& results) override;
+
+private:
+
+	struct SProxy
+	{
+		SmartId sid = InvalidLink;
+		sf::FloatRect bounds;
+		SCollisionFilter filter;
+		bool bValid = false;
+	};
+
+	// The proxies are indexed by the link indices of the SmartIds
+	SProxy* GetProxy(SmartId sid);
+
+	void FillGrid();
+
+private:
+
+	std::vector<SProxy> m_proxies;
+
+	CUniformGrid m_grid;
+	float m_fCellSize = 0.f;
+	float m_fLevelSize = 0.f;
+	bool m_bGridValid = false;
+};
\ No newline at end of file
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @struct SCollisionFilter
+ * Collision layer of the physical entity and the mask of the layers it collides with.
+ * The layers are declared in the entities configuration, each layer occupies one bit.
+ * The default filter belongs to all the layers and collides with everything.
+ */
+struct SCollisionFilter
+{
+	static constexpr int MaxLayers = 32;
+
+	uint32_t layer = ~0u;
+	uint32_t mask = ~0u;
+
+	bool Accepts(const SCollisionFilter& other) const
+	{
+		return (mask & other.layer) != 0 && (other.mask & layer) != 0;
+	}
+};
\ No newline at end of file
@@ -1,20 +1,87 @@
 #include "StdAfx.h"
 #include "PhysicalEntity.h"
+#include "MathHelpers.h"
 
-void CPhysicalEntity::OnTransformChanged(const sf::Transform& transform)
+bool CPhysicalEntity::OnTransformChanged(const sf::Transform& transform)
 {
+	m_transform = transform;
+
+	bool bBecameDirty = !m_bDirty;
+	m_bDirty = true;
+	return bBecameDirty;
+}
+
+bool CPhysicalEntity::UpdateWorldPrimitive()
+{
+	if (!m_bDirty)
+	{
+		return false;
+	}
+
 	if (m_pPrimitive)
 	{
-		m_pPrimitive->Transform(transform * m_transform.getInverse());
+		m_pPrimitive->Transform(*m_pLocalPrimitive, m_transform);
 	}
-	m_transform = transform;
+	m_bDirty = false;
+	return true;
+}
+
+void CPhysicalEntity::UpdateSweep(float fMaxSweepLength)
+{
+	m_bSwept = false;
+
+	sf::Vector2f vA, vB;
+	float fRad;
+	if (!m_bFast || !m_bHasSweepStart || !m_pPrimitive || !PhysicalPrimitive::GetAxis(m_pPrimitive.get(), vA, vB, fRad))
+	{
+		return;
+	}
+
+	sf::Vector2f vDisplacement = 0.5f * (vA + vB - m_vSweepStartA - m_vSweepStartB);
+	if (MathHelpers::DotProd(vDisplacement, vDisplacement) > fMaxSweepLength * fMaxSweepLength)
+	{
+		return;
+	}
+
+	PhysicalPrimitive::MakeSweptCapsule(m_vSweepStartA, m_vSweepStartB, vA, vB, fRad, m_sweptCapsule);
+	m_bSwept = true;
+}
+
+void CPhysicalEntity::ResetSweep()
+{
+	float fRad;
+	m_bSwept = false;
+	m_bHasSweepStart = m_pPrimitive && PhysicalPrimitive::GetAxis(m_pPrimitive.get(), m_vSweepStartA, m_vSweepStartB, fRad);
+}
+
+void CPhysicalEntity::Reset()
+{
+	m_transform = sf::Transform::Identity;
+	if (m_pPrimitive)
+	{
+		m_pPrimitive->Transform(*m_pLocalPrimitive, m_transform);
+	}
+	m_bDirty = false;
+	m_bSwept = false;
+	m_bHasSweepStart = false;
 }
 
-void CPhysicalEntity::OnCollision(SmartId sid)
+void CPhysicalEntity::OnCollision(SmartId sid, ECollisionEvent evt)
 {
 	for (IPhysicalEventListener* pListener : m_eventListeners)
 	{
-		pListener->OnCollision(sid);
+		switch (evt)
+		{
+		case ECollisionEvent_Begin:
+			pListener->OnCollisionBegin(sid);
+			break;
+		case ECollisionEvent_Stay:
+			pListener->OnCollisionStay(sid);
+			break;
+		case ECollisionEvent_End:
+			pListener->OnCollisionEnd(sid);
+			break;
+		}
 	}
 }
 
@@ -2,6 +2,7 @@
 
 #include "EntitySystem.h"
 #include "PhysicalPrimitive.h"
+#include "CollisionFilter.h"
 
 #include <memory>
 #include <vector>
@@ -11,12 +12,24 @@
  * Interface for the collisions' processing.
  * Each IPhysicalEventListener must be registered in the corresponding
  * CPhysicalEntity instance and unregistered before the pointer invalidation.
+ * The contacts persist between the frames, so the listener is notified when
+ * the contact begins, each frame while it stays and when it ends.
+ * The contacts of the removed entities are dropped without the end notification.
  */
 class IPhysicalEventListener
 {
 public:
 
-	virtual void OnCollision(SmartId sid) = 0;
+	virtual void OnCollisionBegin(SmartId sid) = 0;
+	virtual void OnCollisionStay(SmartId sid) {}
+	virtual void OnCollisionEnd(SmartId sid) {}
+};
+
+enum ECollisionEvent
+{
+	ECollisionEvent_Begin,
+	ECollisionEvent_Stay,
+	ECollisionEvent_End,
 };
 
 /**
@@ -25,6 +38,9 @@ public:
  * It owns one of the geometrical primitives, which provide the collision detecion functions.
  * Physical entity is mainly created by the logical entity, so the collision events
  * are sent in the logical system in respect with them.
+ * The fast entities are checked continuously: their collision primitive is the capsule
+ * swept from the pose of the previous collisions' processing to the current one,
+ * so they can't pass through the other objects between the frames.
  */
 class CPhysicalEntity : public CEntity
 {
@@ -32,25 +48,63 @@ public:
 
 	CPhysicalEntity() = default;
 	CPhysicalEntity(std::unique_ptr<PhysicalPrimitive::IPrimitive> pPrimitive)
-		: m_pPrimitive(std::move(pPrimitive)) {}
+		: m_pLocalPrimitive(std::move(pPrimitive))
+		, m_pPrimitive(m_pLocalPrimitive ? m_pLocalPrimitive->Clone() : nullptr) {}
 	
+	// The world primitive, valid after the UpdateWorldPrimitive call
 	const PhysicalPrimitive::IPrimitive* GetPhysics() const { return m_pPrimitive.get(); }
 
+	// The primitive used for the collision detection, either the swept or the actual one
+	const PhysicalPrimitive::IPrimitive* GetCollisionPrimitive() const { return m_bSwept ? &m_sweptCapsule : m_pPrimitive.get(); }
+
+	void SetCollisionFilter(const SCollisionFilter& filter) { m_collisionFilter = filter; }
+	const SCollisionFilter& GetCollisionFilter() const { return m_collisionFilter; }
+
+	void SetFast(bool bFast) { m_bFast = bFast; }
+	bool IsFast() const { return m_bFast; }
+
 	/**
 	 * @function OnTransformChanged
-	 * Recalculate the geometrical properties of the entity.
+	 * Store the new transform of the entity. The world primitive is not
+	 * rebuilt until the UpdateWorldPrimitive call.
 	 * 
 	 * @param transform - the new entity transform.
+	 * @return True if the entity has just become dirty.
+	 */
+	bool OnTransformChanged(const sf::Transform& transform);
+
+	/**
+	 * @function UpdateWorldPrimitive
+	 * Rebuild the world primitive from the local one, if the transform has been changed.
+	 * 
+	 * @return True if the world primitive has been rebuilt.
 	 */
-	void OnTransformChanged(const sf::Transform& transform);
+	bool UpdateWorldPrimitive();
+
+	/**
+	 * @function UpdateSweep
+	 * Rebuild the swept capsule of the fast entity from the sweep start to the current pose.
+	 * The primitives without axis and the entities, moved too far
+	 * (wrapped around the level or teleported), are checked in the current pose only.
+	 * 
+	 * @param fMaxSweepLength - the maximal length of the sweep.
+	 */
+	void UpdateSweep(float fMaxSweepLength);
+
+	// Start the new sweep from the current pose
+	void ResetSweep();
+
+	// Return the entity to the initial pose, keeping the primitives and the listeners
+	void Reset();
 
 	/**
 	 * @function OnCollision
 	 * Retranslate the collision event to the event listeners.
 	 * 
 	 * @param sid - SmartId of the logical entity which the object collided with.
+	 * @param evt - the contact state.
 	 */
-	void OnCollision(SmartId sid);
+	void OnCollision(SmartId sid, ECollisionEvent evt);
 
 	void RegisterEventListener(IPhysicalEventListener* pListener);
 	void UnregisterEventListener(IPhysicalEventListener* pListener);
@@ -60,8 +114,19 @@ public:
 
 private:
 	
+	std::unique_ptr<PhysicalPrimitive::IPrimitive> m_pLocalPrimitive;
 	std::unique_ptr<PhysicalPrimitive::IPrimitive> m_pPrimitive;
 	sf::Transform m_transform;
+	bool m_bDirty = false;
+
+	SCollisionFilter m_collisionFilter;
+
+	bool m_bFast = false;
+	bool m_bSwept = false;
+	bool m_bHasSweepStart = false;
+	sf::Vector2f m_vSweepStartA;
+	sf::Vector2f m_vSweepStartB;
+	PhysicalPrimitive::Capsule m_sweptCapsule{ sf::Vector2f(), sf::Vector2f(), 0.f };
 
 	std::vector<IPhysicalEventListener*> m_eventListeners;
 	SmartId m_parentEntityId = InvalidLink;
@@ -2,25 +2,182 @@
 #include "PhysicalPrimitive.h"
 #include "MathHelpers.h"
 
-void PhysicalPrimitive::Circle::Transform(const sf::Transform& transform)
+#include <algorithm>
+#include <cfloat>
+
+void PhysicalPrimitive::Circle::Transform(const IPrimitive& local, const sf::Transform& transform)
+{
+	const Circle& circle = static_cast<const Circle&>(local);
+	m_vOrg = transform.transformPoint(circle.m_vOrg);
+	m_fRad = circle.m_fRad * MathHelpers::GetScaleAny(transform);
+	UpdateBounds();
+}
+
+void PhysicalPrimitive::Circle::UpdateBounds()
+{
+	m_bounds = sf::FloatRect(m_vOrg.x - m_fRad, m_vOrg.y - m_fRad, 2.f * m_fRad, 2.f * m_fRad);
+	m_vBoundingCenter = m_vOrg;
+	m_fBoundingRadius = m_fRad;
+}
+
+void PhysicalPrimitive::Capsule::Transform(const IPrimitive& local, const sf::Transform& transform)
+{
+	const Capsule& capsule = static_cast<const Capsule&>(local);
+	m_vA = transform.transformPoint(capsule.m_vA);
+	m_vB = transform.transformPoint(capsule.m_vB);
+	m_fRad = capsule.m_fRad * MathHelpers::GetScaleAny(transform);
+	UpdateBounds();
+}
+
+void PhysicalPrimitive::Capsule::Set(const sf::Vector2f& vA, const sf::Vector2f& vB, float fRad)
+{
+	m_vA = vA;
+	m_vB = vB;
+	m_fRad = fRad;
+	UpdateBounds();
+}
+
+void PhysicalPrimitive::Capsule::UpdateBounds()
+{
+	float left = std::min(m_vA.x, m_vB.x) - m_fRad;
+	float top = std::min(m_vA.y, m_vB.y) - m_fRad;
+	float right = std::max(m_vA.x, m_vB.x) + m_fRad;
+	float bottom = std::max(m_vA.y, m_vB.y) + m_fRad;
+	m_bounds = sf::FloatRect(left, top, right - left, bottom - top);
+	m_vBoundingCenter = 0.5f * (m_vA + m_vB);
+	m_fBoundingRadius = 0.5f * MathHelpers::GetLength(m_vA - m_vB) + m_fRad;
+}
+
+PhysicalPrimitive::Polygon::Polygon(const std::vector<sf::Vector2f>& vertices, const std::vector<sf::Vector2f>& normals)
+{
+	m_numVertices = std::min((int)vertices.size(), MaxVertices);
+	std::copy(vertices.begin(), vertices.begin() + m_numVertices, m_vertices);
+
+	m_numNormals = std::min((int)normals.size(), MaxVertices);
+	std::copy(normals.begin(), normals.begin() + m_numNormals, m_normals);
+
+	UpdateBounds();
+}
+
+void PhysicalPrimitive::Polygon::Transform(const IPrimitive& local, const sf::Transform& transform)
+{
+	const Polygon& polygon = static_cast<const Polygon&>(local);
+
+	m_numVertices = polygon.m_numVertices;
+	for (int i = 0; i < m_numVertices; ++i)
+	{
+		m_vertices[i] = transform.transformPoint(polygon.m_vertices[i]);
+	}
+
+	// The normals are transformed by the inverse transposed linear part of the transform.
+	// It's proportional to the adjugate matrix, the determinant is removed by the normalization.
+	const float* matrix = transform.getMatrix();
+	m_numNormals = polygon.m_numNormals;
+	for (int i = 0; i < m_numNormals; ++i)
+	{
+		const sf::Vector2f& n = polygon.m_normals[i];
+		m_normals[i] = MathHelpers::Normalize(sf::Vector2f(matrix[5] * n.x - matrix[1] * n.y, matrix[0] * n.y - matrix[4] * n.x));
+	}
+
+	UpdateBounds();
+}
+
+void PhysicalPrimitive::Polygon::UpdateBounds()
+{
+	if (m_numVertices == 0)
+	{
+		m_bounds = sf::FloatRect();
+		m_vBoundingCenter = sf::Vector2f();
+		m_fBoundingRadius = 0.f;
+		return;
+	}
+
+	sf::Vector2f vMin = m_vertices[0];
+	sf::Vector2f vMax = m_vertices[0];
+	for (int i = 0; i < m_numVertices; ++i)
+	{
+		const sf::Vector2f& vertex = m_vertices[i];
+		vMin.x = std::min(vMin.x, vertex.x);
+		vMin.y = std::min(vMin.y, vertex.y);
+		vMax.x = std::max(vMax.x, vertex.x);
+		vMax.y = std::max(vMax.y, vertex.y);
+	}
+	m_bounds = sf::FloatRect(vMin, vMax - vMin);
+	m_vBoundingCenter = 0.5f * (vMin + vMax);
+
+	float maxDist2 = 0.f;
+	for (int i = 0; i < m_numVertices; ++i)
+	{
+		sf::Vector2f diff = m_vertices[i] - m_vBoundingCenter;
+		maxDist2 = std::max(maxDist2, MathHelpers::DotProd(diff, diff));
+	}
+	m_fBoundingRadius = sqrtf(maxDist2);
+}
+
+static inline float GetDistToSegment2(const sf::Vector2f& vA, const sf::Vector2f& vB, const sf::Vector2f& vPt)
 {
-	m_vOrg = transform.transformPoint(m_vOrg);
-	m_fRad *= MathHelpers::GetScaleAny(transform);
+	sf::Vector2f vDir = vB - vA;
+	float len2 = MathHelpers::DotProd(vDir, vDir);
+	float t = len2 > 0.f ? std::clamp(MathHelpers::DotProd(vPt - vA, vDir) / len2, 0.f, 1.f) : 0.f;
+	sf::Vector2f diff = vPt - (vA + t * vDir);
+	return MathHelpers::DotProd(diff, diff);
 }
 
-void PhysicalPrimitive::Capsule::Transform(const sf::Transform& transform)
+bool PhysicalPrimitive::GetAxis(const IPrimitive* pPrimitive, sf::Vector2f& vA, sf::Vector2f& vB, float& fRad)
 {
-	m_vA = transform.transformPoint(m_vA);
-	m_vB = transform.transformPoint(m_vB);
-	m_fRad *= MathHelpers::GetScaleAny(transform);
+	switch (pPrimitive->GetType())
+	{
+	case EPrimitiveType_Circle:
+	{
+		const Circle* pCircle = static_cast<const Circle*>(pPrimitive);
+		vA = vB = pCircle->m_vOrg;
+		fRad = pCircle->m_fRad;
+		return true;
+	}
+	case EPrimitiveType_Capsule:
+	{
+		const Capsule* pCapsule = static_cast<const Capsule*>(pPrimitive);
+		vA = pCapsule->m_vA;
+		vB = pCapsule->m_vB;
+		fRad = pCapsule->m_fRad;
+		return true;
+	}
+	default:
+		return false;
+	}
 }
 
-void PhysicalPrimitive::Polygon::Transform(const sf::Transform& transform)
+void PhysicalPrimitive::MakeSweptCapsule(const sf::Vector2f& vA0, const sf::Vector2f& vB0,
+	const sf::Vector2f& vA1, const sf::Vector2f& vB1, float fRad, Capsule& swept)
 {
-	for (auto& vertex : m_vertices)
+	const sf::Vector2f points[] = { vA0, vB0, vA1, vB1 };
+
+	// The most distant points become the axis of the swept capsule
+	int best1 = 0, best2 = 0;
+	float maxDist2 = -1.f;
+	for (int i = 0; i < 4; ++i)
+	{
+		for (int j = i + 1; j < 4; ++j)
+		{
+			sf::Vector2f diff = points[i] - points[j];
+			float dist2 = MathHelpers::DotProd(diff, diff);
+			if (dist2 > maxDist2)
+			{
+				maxDist2 = dist2;
+				best1 = i;
+				best2 = j;
+			}
+		}
+	}
+
+	// and the radius is extended to cover the rest of them
+	float maxDev2 = 0.f;
+	for (int i = 0; i < 4; ++i)
 	{
-		vertex = transform.transformPoint(vertex);
+		maxDev2 = std::max(maxDev2, GetDistToSegment2(points[best1], points[best2], points[i]));
 	}
+
+	swept.Set(points[best1], points[best2], fRad + sqrtf(maxDev2));
 }
 
 #define INTERSECTION(T1, T2) Intersection_##T1##_##T2
@@ -61,19 +218,23 @@ IMPLEMENT_INTERSECTION(Capsule, Capsule)
 {
 	CAST_ARGS(Capsule, c1, Capsule, c2);
 
-	float d2a1a2 = MathHelpers::DotProd(c1->m_vA, c2->m_vA);
-	float d2a1b2 = MathHelpers::DotProd(c1->m_vB, c2->m_vB);
-	float d2b1a2 = MathHelpers::DotProd(c1->m_vB, c2->m_vA);
-	float d2b1b2 = MathHelpers::DotProd(c1->m_vB, c2->m_vB);
-
-	sf::Vector2f best1 = (d2b1a2 < d2a1a2 || d2b1a2 < d2a1b2 || d2b1b2 < d2a1a2 || d2b1b2 < d2a1b2) ? c1->m_vB : c1->m_vA;
-	sf::Vector2f best2 = FindClosestPointOnCapsuleAxis(c2, best1);
-	best1 = FindClosestPointOnCapsuleAxis(c1, best2);
-
-	PhysicalPrimitive::Circle c1c(best1, c1->m_fRad);
-	PhysicalPrimitive::Circle c2c(best2, c2->m_fRad);
+	// The crossing axes always intersect
+	float a1 = MathHelpers::CrossProd(c1->m_vB - c1->m_vA, c2->m_vA - c1->m_vA);
+	float b1 = MathHelpers::CrossProd(c1->m_vB - c1->m_vA, c2->m_vB - c1->m_vA);
+	float a2 = MathHelpers::CrossProd(c2->m_vB - c2->m_vA, c1->m_vA - c2->m_vA);
+	float b2 = MathHelpers::CrossProd(c2->m_vB - c2->m_vA, c1->m_vB - c2->m_vA);
+	if (a1 * b1 < 0.f && a2 * b2 < 0.f)
+	{
+		return true;
+	}
 
-	return INTERSECTION(Circle, Circle)(&c1c, &c2c);
+	// Otherwise the closest points of the axes include one of the endpoints.
+	// Both the axes are checked precisely, since the swept capsules could be very long
+	float dist2 = std::min(
+		std::min(GetDistToSegment2(c2->m_vA, c2->m_vB, c1->m_vA), GetDistToSegment2(c2->m_vA, c2->m_vB, c1->m_vB)),
+		std::min(GetDistToSegment2(c1->m_vA, c1->m_vB, c2->m_vA), GetDistToSegment2(c1->m_vA, c1->m_vB, c2->m_vB)));
+	float width = c1->m_fRad + c2->m_fRad;
+	return dist2 <= width * width;
 }
 
 IMPLEMENT_INTERSECTION(Circle, Capsule)
@@ -91,8 +252,10 @@ IMPLEMENT_INTERSECTION(Capsule, Circle)
 	return INTERSECTION(Circle, Capsule)(p2, p1);
 }
 
-inline static void CalculateNormals(const std::vector<sf::Vector2f>& vertices, std::vector<sf::Vector2f>& normals)
+void PhysicalPrimitive::CalculateNormals(const std::vector<sf::Vector2f>& vertices, std::vector<sf::Vector2f>& normals)
 {
+	normals.clear();
+
 	if (vertices.size() < 2)
 	{
 		return;
@@ -115,24 +278,27 @@ inline static void CalculateNormals(const std::vector<sf::Vector2f>& vertices, s
 	{
 		sf::Vector2f dir(pt2 - pt1);
 		sf::Vector2f norm = MathHelpers::Normalize(sf::Vector2f(dir.y, -dir.x));
-		pushIfNotExist(norm);
+		if (norm != sf::Vector2f())
+		{
+			pushIfNotExist(norm);
+		}
 	};
 
 	for (int i = 1; i < vertices.size(); ++i)
 	{
-		findNorm(vertices[i - 1], vertices[1]);
+		findNorm(vertices[i - 1], vertices[i]);
 	}
 	findNorm(vertices[0], vertices[vertices.size() - 1]);
 }
 
-inline static void CalculateMinMaxProjects(const std::vector<sf::Vector2f>& vertices, const sf::Vector2f& normal, float& min, float& max)
+inline static void CalculateMinMaxProjects(const PhysicalPrimitive::Polygon* pg, const sf::Vector2f& normal, float& min, float& max)
 {
 	min = FLT_MAX;
-	max = FLT_MIN;
+	max = -FLT_MAX;
 
-	for (const auto& vertex : vertices)
+	for (int i = 0; i < pg->m_numVertices; ++i)
 	{
-		float proj = MathHelpers::DotProd(normal, vertex);
+		float proj = MathHelpers::DotProd(normal, pg->m_vertices[i]);
 		
 		if (proj < min)
 		{
@@ -149,18 +315,26 @@ inline static void CalculateMinMaxProjects(const std::vector<sf::Vector2f>& vert
 IMPLEMENT_INTERSECTION(Polygon, Polygon)
 {
 	CAST_ARGS(Polygon, pg1, Polygon, pg2);
-	
-	std::vector<sf::Vector2f> normals;
-	CalculateNormals(pg1->m_vertices, normals);
-	CalculateNormals(pg2->m_vertices, normals);
 
-	for (const auto& normal : normals)
+	auto isSeparated = [pg1, pg2](const sf::Vector2f& normal)
 	{
 		float min1, min2, max1, max2;
-		CalculateMinMaxProjects(pg1->m_vertices, normal, min1, max1);
-		CalculateMinMaxProjects(pg2->m_vertices, normal, min2, max2);
-		
-		if (min1 > max2 || min2 > max1)
+		CalculateMinMaxProjects(pg1, normal, min1, max1);
+		CalculateMinMaxProjects(pg2, normal, min2, max2);
+		return min1 > max2 || min2 > max1;
+	};
+
+	for (int i = 0; i < pg1->m_numNormals; ++i)
+	{
+		if (isSeparated(pg1->m_normals[i]))
+		{
+			return false;
+		}
+	}
+
+	for (int i = 0; i < pg2->m_numNormals; ++i)
+	{
+		if (isSeparated(pg2->m_normals[i]))
 		{
 			return false;
 		}
@@ -169,49 +343,68 @@ IMPLEMENT_INTERSECTION(Polygon, Polygon)
 	return true;
 }
 
-IMPLEMENT_INTERSECTION(Polygon, Circle)
+// The round primitives are tested by the distance from their axis to the polygon
+static bool IntersectPolygonWithAxis(const PhysicalPrimitive::Polygon* pg, const sf::Vector2f& vA, const sf::Vector2f& vB, float fRad)
 {
-	CAST_ARGS(Polygon, pg, Circle, c);
-
-	std::vector<sf::Vector2f> normals;
-	CalculateNormals(pg->m_vertices, normals);
+	if (pg->m_numVertices == 0)
+	{
+		return false;
+	}
 
-	for (const auto& normal : normals)
+	// The axis is inside or crosses the polygon if no separating axis exists
+	auto isSeparated = [pg, &vA, &vB](const sf::Vector2f& normal)
 	{
 		float min1, max1;
-		CalculateMinMaxProjects(pg->m_vertices, normal, min1, max1);
-		
-		float centerProj = MathHelpers::DotProd(normal, c->m_vOrg);
-		float min2 = centerProj - c->m_fRad;
-		float max2 = centerProj + c->m_fRad;
+		CalculateMinMaxProjects(pg, normal, min1, max1);
+
+		float projA = MathHelpers::DotProd(normal, vA);
+		float projB = MathHelpers::DotProd(normal, vB);
+		return min1 > std::max(projA, projB) || std::min(projA, projB) > max1;
+	};
 
-		if (min1 > max2 || min2 > max1)
+	bool bSeparated = false;
+	for (int i = 0; i < pg->m_numNormals && !bSeparated; ++i)
+	{
+		bSeparated = isSeparated(pg->m_normals[i]);
+	}
+
+	sf::Vector2f vDir = vB - vA;
+	if (!bSeparated && vDir != sf::Vector2f())
+	{
+		bSeparated = isSeparated(sf::Vector2f(vDir.y, -vDir.x));
+	}
+
+	if (!bSeparated)
+	{
+		return true;
+	}
+
+	// Otherwise the closest points of the axis and the polygon edge include one of the endpoints
+	float fRad2 = fRad * fRad;
+	for (int i = 0; i < pg->m_numVertices; ++i)
+	{
+		const sf::Vector2f& v1 = pg->m_vertices[i];
+		const sf::Vector2f& v2 = pg->m_vertices[(i + 1) % pg->m_numVertices];
+
+		if (GetDistToSegment2(vA, vB, v1) <= fRad2 || GetDistToSegment2(v1, v2, vA) <= fRad2 || GetDistToSegment2(v1, v2, vB) <= fRad2)
 		{
-			return false;
+			return true;
 		}
 	}
 
-	return true;
+	return false;
+}
+
+IMPLEMENT_INTERSECTION(Polygon, Circle)
+{
+	CAST_ARGS(Polygon, pg, Circle, c);
+	return IntersectPolygonWithAxis(pg, c->m_vOrg, c->m_vOrg, c->m_fRad);
 }
 
 IMPLEMENT_INTERSECTION(Polygon, Capsule)
 {
 	CAST_ARGS(Polygon, pg, Capsule, c);
-
-	sf::Vector2f capsuleAxis = MathHelpers::Normalize(c->m_vA - c->m_vB);
-	sf::Vector2f capsuleNorm(capsuleAxis.y, -capsuleAxis.x);
-
-	std::vector<sf::Vector2f> capsuleVertices;
-	capsuleVertices.push_back(c->m_vB + c->m_fRad * capsuleNorm);
-	capsuleVertices.push_back(c->m_vB + c->m_fRad * -capsuleNorm);
-	capsuleVertices.push_back(c->m_vA + c->m_fRad * capsuleNorm);
-	capsuleVertices.push_back(c->m_vA + c->m_fRad * -capsuleNorm);
-
-	PhysicalPrimitive::Polygon cpg(capsuleVertices);
-	PhysicalPrimitive::Circle cc1(c->m_vA, c->m_fRad);
-	PhysicalPrimitive::Circle cc2(c->m_vB, c->m_fRad);
-
-	return INTERSECTION(Polygon, Circle)(pg, &cc1) || INTERSECTION(Polygon, Circle)(pg, &cc2) || INTERSECTION(Polygon, Polygon)(pg, &cpg);
+	return IntersectPolygonWithAxis(pg, c->m_vA, c->m_vB, c->m_fRad);
 }
 
 IMPLEMENT_INTERSECTION(Circle, Polygon)
@@ -229,4 +422,144 @@ Intersection g_intersectionsTable[PhysicalPrimitive::EPrimitiveType_Num][Physica
 	Intersection_Circle_Circle, Intersection_Circle_Capsule, Intersection_Circle_Polygon,
 	Intersection_Capsule_Circle, Intersection_Capsule_Capsule, Intersection_Capsule_Polygon,
 	Intersection_Polygon_Circle, Intersection_Polygon_Capsule, Intersection_Polygon_Polygon
+};
+
+#define RAYCAST(T) Raycast_##T
+#define IMPLEMENT_RAYCAST(T) static bool RAYCAST(T)(const PhysicalPrimitive::IPrimitive* p, const sf::Vector2f& vOrg, const sf::Vector2f& vDir, float fMaxDist, float& fDist)
+
+static inline bool RaycastCircle(const sf::Vector2f& vCenter, float fRad, const sf::Vector2f& vOrg, const sf::Vector2f& vDir, float fMaxDist, float& fDist)
+{
+	sf::Vector2f m = vOrg - vCenter;
+	float c = MathHelpers::DotProd(m, m) - fRad * fRad;
+	if (c <= 0.f)
+	{
+		fDist = 0.f;
+		return true;
+	}
+
+	float b = MathHelpers::DotProd(m, vDir);
+	float disc = b * b - c;
+	if (b > 0.f || disc < 0.f)
+	{
+		return false;
+	}
+
+	float t = -b - sqrtf(disc);
+	if (t > fMaxDist)
+	{
+		return false;
+	}
+
+	fDist = t;
+	return true;
+}
+
+static inline bool RaycastSegment(const sf::Vector2f& vA, const sf::Vector2f& vB, const sf::Vector2f& vOrg, const sf::Vector2f& vDir, float fMaxDist, float& fDist)
+{
+	sf::Vector2f vEdge = vB - vA;
+	float denom = MathHelpers::CrossProd(vDir, vEdge);
+	if (denom == 0.f)
+	{
+		return false;
+	}
+
+	sf::Vector2f diff = vA - vOrg;
+	float t = MathHelpers::CrossProd(diff, vEdge) / denom;
+	float s = MathHelpers::CrossProd(diff, vDir) / denom;
+	if (t < 0.f || t > fMaxDist || s < 0.f || s > 1.f)
+	{
+		return false;
+	}
+
+	fDist = t;
+	return true;
+}
+
+IMPLEMENT_RAYCAST(Circle)
+{
+	const PhysicalPrimitive::Circle* c = static_cast<const PhysicalPrimitive::Circle*>(p);
+	return RaycastCircle(c->m_vOrg, c->m_fRad, vOrg, vDir, fMaxDist, fDist);
+}
+
+IMPLEMENT_RAYCAST(Capsule)
+{
+	const PhysicalPrimitive::Capsule* c = static_cast<const PhysicalPrimitive::Capsule*>(p);
+
+	if (GetDistToSegment2(c->m_vA, c->m_vB, vOrg) <= c->m_fRad * c->m_fRad)
+	{
+		fDist = 0.f;
+		return true;
+	}
+
+	// The capsule border consists of the two end circles and the two sides
+	sf::Vector2f vNorm = MathHelpers::Normalize(c->m_vA - c->m_vB);
+	vNorm = sf::Vector2f(vNorm.y, -vNorm.x) * c->m_fRad;
+
+	bool bHit = false;
+	float fDistance;
+	auto test = [&](bool bCurrHit)
+	{
+		if (bCurrHit)
+		{
+			fMaxDist = fDistance;
+			bHit = true;
+		}
+	};
+
+	test(RaycastCircle(c->m_vA, c->m_fRad, vOrg, vDir, fMaxDist, fDistance));
+	test(RaycastCircle(c->m_vB, c->m_fRad, vOrg, vDir, fMaxDist, fDistance));
+	test(RaycastSegment(c->m_vA + vNorm, c->m_vB + vNorm, vOrg, vDir, fMaxDist, fDistance));
+	test(RaycastSegment(c->m_vA - vNorm, c->m_vB - vNorm, vOrg, vDir, fMaxDist, fDistance));
+
+	if (bHit)
+	{
+		fDist = fMaxDist;
+	}
+	return bHit;
+}
+
+IMPLEMENT_RAYCAST(Polygon)
+{
+	const PhysicalPrimitive::Polygon* pg = static_cast<const PhysicalPrimitive::Polygon*>(p);
+	if (pg->m_numVertices == 0)
+	{
+		return false;
+	}
+
+	// The origin is inside the convex polygon if it's on the same side of all the edges
+	bool bPositive = false, bNegative = false;
+	bool bHit = false;
+	for (int i = 0; i < pg->m_numVertices; ++i)
+	{
+		const sf::Vector2f& v1 = pg->m_vertices[i];
+		const sf::Vector2f& v2 = pg->m_vertices[(i + 1) % pg->m_numVertices];
+
+		float side = MathHelpers::CrossProd(v2 - v1, vOrg - v1);
+		bPositive |= side > 0.f;
+		bNegative |= side < 0.f;
+
+		float fDistance;
+		if (RaycastSegment(v1, v2, vOrg, vDir, fMaxDist, fDistance))
+		{
+			fMaxDist = fDistance;
+			bHit = true;
+		}
+	}
+
+	if (!(bPositive && bNegative))
+	{
+		fDist = 0.f;
+		return true;
+	}
+
+	if (bHit)
+	{
+		fDist = fMaxDist;
+	}
+	return bHit;
+}
+
+Raycast g_raycastTable[PhysicalPrimitive::EPrimitiveType_Num] =
+{
+	Raycast_Circle, Raycast_Capsule, Raycast_Polygon
 };
\ No newline at end of file
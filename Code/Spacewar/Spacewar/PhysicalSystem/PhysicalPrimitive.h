@@ -1,8 +1,10 @@
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include <SFML/Graphics/Transform.hpp>
+#include <SFML/Graphics/Rect.hpp>
 
 namespace PhysicalPrimitive
 {
@@ -17,53 +19,171 @@ namespace PhysicalPrimitive
 	/**
 	 * @interface IPrimitive
 	 * This struct provides the functions to distinguish the primitives
-	 * between themselves and to change their properties according to the new entity transform.
+	 * between themselves and to build the world primitive from the local one and the entity transform.
+	 * Each primitive also caches it's bounding box and bounding circle, which are
+	 * recalculated on every transform. They are used to reject the distant pairs of the primitives
+	 * before the actual intersection test.
 	 */
 	struct IPrimitive
 	{
+		virtual ~IPrimitive() = default;
+
 		virtual EPrimitiveType GetType() const = 0;
-		virtual void Transform(const sf::Transform& transform) = 0;
+		virtual std::unique_ptr<IPrimitive> Clone() const = 0;
+
+		/**
+		 * @function Transform
+		 * Set the primitive to the transformed one.
+		 * 
+		 * @param local - the primitive of the same type in the local space.
+		 * @param transform - the transform to apply.
+		 */
+		virtual void Transform(const IPrimitive& local, const sf::Transform& transform) = 0;
+
+		const sf::FloatRect& GetBoundingBox() const { return m_bounds; }
+		const sf::Vector2f& GetBoundingCenter() const { return m_vBoundingCenter; }
+		float GetBoundingRadius() const { return m_fBoundingRadius; }
+
+	protected:
+
+		sf::FloatRect m_bounds;
+		sf::Vector2f m_vBoundingCenter;
+		float m_fBoundingRadius = 0.f;
 	};
 
 	// Circle is defined by the origin and radius.
 	struct Circle : public IPrimitive
 	{
-		Circle(const sf::Vector2f& vOrg, float fRad) : m_vOrg(vOrg), m_fRad(fRad) {}
-		Circle(float fRad) : m_fRad(fRad) {}
+		Circle(const sf::Vector2f& vOrg, float fRad) : m_vOrg(vOrg), m_fRad(fRad) { UpdateBounds(); }
+		Circle(float fRad) : m_fRad(fRad) { UpdateBounds(); }
 
 		virtual EPrimitiveType GetType() const override { return EPrimitiveType_Circle; }
-		virtual void Transform(const sf::Transform& transform) override;
+		virtual std::unique_ptr<IPrimitive> Clone() const override { return std::make_unique<Circle>(*this); }
+		virtual void Transform(const IPrimitive& local, const sf::Transform& transform) override;
 
 		sf::Vector2f m_vOrg;
 		float m_fRad = 0.f;
+
+	private:
+
+		void UpdateBounds();
 	};
 
 	// Capsule is defined by the two axes points and radius around the axis
 	struct Capsule : public IPrimitive
 	{
 		Capsule(const sf::Vector2f& vA, const sf::Vector2f& vB, float fRad)
-			: m_vA(vA), m_vB(vB), m_fRad(fRad) {}
+			: m_vA(vA), m_vB(vB), m_fRad(fRad) { UpdateBounds(); }
 
 		virtual EPrimitiveType GetType() const override { return EPrimitiveType_Capsule; }
-		virtual void Transform(const sf::Transform& transform) override;
+		virtual std::unique_ptr<IPrimitive> Clone() const override { return std::make_unique<Capsule>(*this); }
+		virtual void Transform(const IPrimitive& local, const sf::Transform& transform) override;
+
+		void Set(const sf::Vector2f& vA, const sf::Vector2f& vB, float fRad);
 
 		sf::Vector2f m_vA;
 		sf::Vector2f m_vB;
 		float m_fRad = 0.f;
+
+	private:
+
+		void UpdateBounds();
 	};
 
-	// Polygon is defined by the vertices positions
+	/**
+	 * Polygon is defined by the vertices positions of the convex polygon in the traversal order.
+	 * The unique normals of the edges (separating axes) are calculated once with the configuration
+	 * and transformed together with the vertices. Both are stored in place, so the polygon
+	 * never allocates the memory.
+	 */
 	struct Polygon : public IPrimitive
 	{
-		Polygon(const std::vector<sf::Vector2f>& vertices) : m_vertices(vertices) {}
+		static constexpr int MaxVertices = 16;
+
+		Polygon(const std::vector<sf::Vector2f>& vertices, const std::vector<sf::Vector2f>& normals);
 
 		virtual EPrimitiveType GetType() const override { return EPrimitiveType_Polygon; }
-		virtual void Transform(const sf::Transform& transform) override;
+		virtual std::unique_ptr<IPrimitive> Clone() const override { return std::make_unique<Polygon>(*this); }
+		virtual void Transform(const IPrimitive& local, const sf::Transform& transform) override;
+
+		sf::Vector2f m_vertices[MaxVertices];
+		sf::Vector2f m_normals[MaxVertices];
+		int m_numVertices = 0;
+		int m_numNormals = 0;
 
-		std::vector<sf::Vector2f> m_vertices;
+	private:
+
+		void UpdateBounds();
 	};
+
+	/**
+	 * @function CalculateNormals
+	 * Calculate the unique normalized normals of the polygon edges.
+	 * 
+	 * @param vertices - vertices of the convex polygon in the traversal order.
+	 * @param normals - output normals.
+	 */
+	void CalculateNormals(const std::vector<sf::Vector2f>& vertices, std::vector<sf::Vector2f>& normals);
+
+	/**
+	 * @function GetAxis
+	 * Get the axis segment and radius of the round primitives (the circle is
+	 * considered as the capsule with the zero length axis).
+	 * 
+	 * @return False if the primitive has no axis.
+	 */
+	bool GetAxis(const IPrimitive* pPrimitive, sf::Vector2f& vA, sf::Vector2f& vB, float& fRad);
+
+	/**
+	 * @function MakeSweptCapsule
+	 * Build the capsule enclosing the moving capsule between two poses. The swept capsule
+	 * is exact for the capsules moving along their axis (like the projectiles do)
+	 * and conservative for the others.
+	 * 
+	 * @param vA0, vB0 - capsule axis in the start pose.
+	 * @param vA1, vB1 - capsule axis in the end pose.
+	 * @param fRad - capsule radius.
+	 * @param swept - output swept capsule.
+	 */
+	void MakeSweptCapsule(const sf::Vector2f& vA0, const sf::Vector2f& vB0,
+		const sf::Vector2f& vA1, const sf::Vector2f& vB1, float fRad, Capsule& swept);
+
+	/**
+	 * @function BoundsIntersect
+	 * Cheap conservative test of the primitives' cached bounds.
+	 * 
+	 * @return False if the primitives definitely don't intersect, true otherwise.
+	 */
+	inline bool BoundsIntersect(const IPrimitive* p1, const IPrimitive* p2)
+	{
+		const sf::FloatRect& b1 = p1->GetBoundingBox();
+		const sf::FloatRect& b2 = p2->GetBoundingBox();
+		if (b1.left > b2.left + b2.width || b2.left > b1.left + b1.width ||
+			b1.top > b2.top + b2.height || b2.top > b1.top + b1.height)
+		{
+			return false;
+		}
+
+		sf::Vector2f diff = p1->GetBoundingCenter() - p2->GetBoundingCenter();
+		float width = p1->GetBoundingRadius() + p2->GetBoundingRadius();
+		return diff.x * diff.x + diff.y * diff.y <= width * width;
+	}
 }
 
 typedef bool(*Intersection)(const PhysicalPrimitive::IPrimitive*, const PhysicalPrimitive::IPrimitive*);
 
-extern Intersection g_intersectionsTable[PhysicalPrimitive::EPrimitiveType_Num][PhysicalPrimitive::EPrimitiveType_Num];
\ No newline at end of file
+extern Intersection g_intersectionsTable[PhysicalPrimitive::EPrimitiveType_Num][PhysicalPrimitive::EPrimitiveType_Num];
+
+/**
+ * Raycast function finds the distance along the ray to the first intersection with the primitive.
+ * The ray starting inside the primitive hits it at the zero distance.
+ * 
+ * @param vOrg - origin of the ray.
+ * @param vDir - normalized direction of the ray.
+ * @param fMaxDist - length of the ray.
+ * @param fDist - output distance to the hit.
+ * @return True if the primitive is hit.
+ */
+typedef bool(*Raycast)(const PhysicalPrimitive::IPrimitive*, const sf::Vector2f& vOrg, const sf::Vector2f& vDir, float fMaxDist, float& fDist);
+
+extern Raycast g_raycastTable[PhysicalPrimitive::EPrimitiveType_Num];
\ No newline at end of file
@@ -1,7 +1,42 @@
 #include "StdAfx.h"
 #include "PhysicalSystem.h"
+#include "SweepAndPrune.h"
+#include "Game.h"
+#include "TaskScheduler.h"
+#include "LogicalSystem/LogicalSystem.h"
+#include "LogicalSystem/LevelSystem.h"
+#include "ConfigurationSystem/ConfigurationSystem.h"
+#include "MathHelpers.h"
 
-SmartId CPhysicalSystem::CreateEntityWithPrimitive(PhysicalPrimitive::EPrimitiveType type, const CEntityConfiguration::IPrimitiveConfig* pConfig)
+#include <cfloat>
+#include <algorithm>
+
+#include <SFML/System/Clock.hpp>
+
+static constexpr int NarrowPhaseBatchSize = 64;
+
+CPhysicalSystem::CPhysicalSystem()
+	: CEntitySystem(128)
+{
+	const CConfigurationSystem::SPhysicsConfiguration& config = CGame::Get().GetConfigurationSystem()->GetPhysicsConfiguration();
+	switch (config.broadphase)
+	{
+	case CConfigurationSystem::SPhysicsConfiguration::Grid:
+		m_pBroadphase = std::make_unique<CGridBroadphase>(config.fGridCellSize);
+		break;
+	case CConfigurationSystem::SPhysicsConfiguration::SweepAndPrune:
+		m_pBroadphase = std::make_unique<CSweepAndPrune>();
+		break;
+	default:
+		m_pBroadphase = std::make_unique<CBruteForceBroadphase>();
+		break;
+	}
+}
+
+CPhysicalSystem::~CPhysicalSystem() = default;
+
+SmartId CPhysicalSystem::CreateEntityWithPrimitive(PhysicalPrimitive::EPrimitiveType type, const CEntityConfiguration::IPrimitiveConfig* pConfig,
+	const SCollisionFilter& filter, bool bFast)
 {
 	std::unique_ptr<PhysicalPrimitive::IPrimitive> pPrimitive;
 
@@ -23,28 +58,349 @@ SmartId CPhysicalSystem::CreateEntityWithPrimitive(PhysicalPrimitive::EPrimitive
 	case PhysicalPrimitive::EPrimitiveType_Polygon:
 		if (const CEntityConfiguration::PolygonConfig* pPolygonConfig = static_cast<const CEntityConfiguration::PolygonConfig*>(pConfig))
 		{
-			pPrimitive = std::make_unique<PhysicalPrimitive::Polygon>(pPolygonConfig->vertices);
+			pPrimitive = std::make_unique<PhysicalPrimitive::Polygon>(pPolygonConfig->vertices, pPolygonConfig->normals);
 		}
 		break;
 	}
 
-	return CreateEntity(std::move(pPrimitive));
+	sf::FloatRect bounds = pPrimitive ? pPrimitive->GetBoundingBox() : sf::FloatRect();
+	bool bHasPrimitive = pPrimitive != nullptr;
+
+	SmartId sid = CreateEntity(std::move(pPrimitive));
+	if (bHasPrimitive)
+	{
+		m_pBroadphase->AddProxy(sid, bounds, filter);
+	}
+
+	if (CPhysicalEntity* pEntity = GetEntity(sid))
+	{
+		pEntity->SetCollisionFilter(filter);
+
+		if (bFast)
+		{
+			pEntity->SetFast(true);
+			m_fastEntities.push_back(sid);
+		}
+	}
+
+	return sid;
+}
+
+void CPhysicalSystem::OnEntityTransformChanged(SmartId sid, const sf::Transform& transform)
+{
+	if (CPhysicalEntity* pEntity = GetEntity(sid))
+	{
+		if (pEntity->OnTransformChanged(transform))
+		{
+			m_dirtyEntities.push_back(sid);
+		}
+	}
+}
+
+void CPhysicalSystem::UpdateDirtyEntities()
+{
+	for (SmartId sid : m_dirtyEntities)
+	{
+		CPhysicalEntity* pEntity = GetEntity(sid);
+		if (!pEntity)
+		{
+			continue;
+		}
+
+		// The world primitive could be already rebuilt (see ProcessCollisions)
+		UpdateWorldPrimitive(*pEntity);
+
+		if (const auto* pPhysics = pEntity->GetCollisionPrimitive())
+		{
+			m_pBroadphase->UpdateProxy(sid, pPhysics->GetBoundingBox());
+		}
+	}
+	m_dirtyEntities.clear();
+}
+
+void CPhysicalSystem::UpdateWorldPrimitive(CPhysicalEntity& entity) const
+{
+	if (entity.UpdateWorldPrimitive() && entity.IsFast())
+	{
+		entity.UpdateSweep(m_fMaxSweepLength);
+	}
+}
+
+void CPhysicalSystem::RemoveEntity(SmartId sid, bool immediate)
+{
+	if (CPhysicalEntity* pEntity = GetEntity(sid))
+	{
+		m_pBroadphase->RemoveProxy(sid);
+
+		if (pEntity->IsFast())
+		{
+			auto fnd = std::find(m_fastEntities.begin(), m_fastEntities.end(), sid);
+			if (fnd != m_fastEntities.end())
+			{
+				*fnd = m_fastEntities.back();
+				m_fastEntities.pop_back();
+			}
+		}
+	}
+	CEntitySystem::RemoveEntity(sid, immediate);
+}
+
+SmartId CPhysicalSystem::RecycleEntity(SmartId sid)
+{
+	CPhysicalEntity* pEntity = GetEntity(sid);
+	if (!pEntity)
+	{
+		return InvalidLink;
+	}
+
+	m_pBroadphase->RemoveProxy(sid);
+
+	if (pEntity->IsFast())
+	{
+		auto fnd = std::find(m_fastEntities.begin(), m_fastEntities.end(), sid);
+		if (fnd != m_fastEntities.end())
+		{
+			*fnd = m_fastEntities.back();
+			m_fastEntities.pop_back();
+		}
+	}
+
+	pEntity->Reset();
+	return ReissueId(sid);
+}
+
+void CPhysicalSystem::RestoreEntity(SmartId sid)
+{
+	if (CPhysicalEntity* pEntity = GetEntity(sid))
+	{
+		if (const auto* pPhysics = pEntity->GetPhysics())
+		{
+			m_pBroadphase->AddProxy(sid, pPhysics->GetBoundingBox(), pEntity->GetCollisionFilter());
+		}
+
+		if (pEntity->IsFast())
+		{
+			m_fastEntities.push_back(sid);
+		}
+	}
+}
+
+void CPhysicalSystem::Clear()
+{
+	m_pBroadphase->Clear();
+	m_fastEntities.clear();
+	m_dirtyEntities.clear();
+	m_prevContacts.clear();
+	CEntitySystem::Clear();
 }
 
 void CPhysicalSystem::ProcessCollisions()
 {
-	for (int i = 0; i < m_entities.size(); ++i)
+	sf::Clock clock;
+
+	float fLevelSize = CGame::Get().GetLogicalSystem()->GetLevelSystem()->GetLevelSize();
+	m_pBroadphase->SetLevelSize(fLevelSize);
+
+	// The longer displacements are the wraps around the level
+	m_fMaxSweepLength = fLevelSize > 0.f ? 0.5f * fLevelSize : FLT_MAX;
+
+	// The world primitives don't depend on each other, so they are rebuilt in parallel,
+	// and only the broadphase proxies are updated one by one
+	CTaskScheduler* pTaskScheduler = CGame::Get().GetTaskScheduler();
+	ForEachEntityParallel(*pTaskScheduler, [this](CPhysicalEntity& entity) { UpdateWorldPrimitive(entity); });
+	UpdateDirtyEntities();
+
+	m_pBroadphase->CollectPairs(m_candidates);
+
+	m_statistics.numCandidates = (int)m_candidates.size();
+	m_statistics.numRejected = 0;
+	m_statistics.numCollisions = 0;
+
+	// The narrow phase doesn't change anything but the contact buffers, so the candidates
+	// are tested in parallel, and the collision events are sent after that
+	m_contactBuffers.resize(pTaskScheduler->GetNumThreads());
+	for (auto& buffer : m_contactBuffers)
+	{
+		buffer.contacts.clear();
+		buffer.numRejected = 0;
+	}
+
+	pTaskScheduler->ParallelFor((int)m_candidates.size(), NarrowPhaseBatchSize, [this](int begin, int end, int thread)
+		{
+			SContactBuffer& buffer = m_contactBuffers[thread];
+			for (int i = begin; i < end; ++i)
+			{
+				const CPhysicalEntity* pEntity1 = GetEntity(m_candidates[i].first);
+				const CPhysicalEntity* pEntity2 = GetEntity(m_candidates[i].second);
+				if (!pEntity1 || !pEntity2)
+				{
+					continue;
+				}
+
+				const auto* pPhysics1 = pEntity1->GetCollisionPrimitive();
+				const auto* pPhysics2 = pEntity2->GetCollisionPrimitive();
+
+				if (!PhysicalPrimitive::BoundsIntersect(pPhysics1, pPhysics2))
+				{
+					++buffer.numRejected;
+					continue;
+				}
+
+				if (g_intersectionsTable[pPhysics1->GetType()][pPhysics2->GetType()](pPhysics1, pPhysics2))
+				{
+					buffer.contacts.push_back(m_candidates[i]);
+				}
+			}
+		});
+
+	// The events are sent in the order of the entities' ids regardless of the threads' timings
+	m_contacts.clear();
+	for (const auto& buffer : m_contactBuffers)
+	{
+		m_contacts.insert(m_contacts.end(), buffer.contacts.begin(), buffer.contacts.end());
+		m_statistics.numRejected += buffer.numRejected;
+	}
+	std::sort(m_contacts.begin(), m_contacts.end());
+
+	m_statistics.numCollisions = (int)m_contacts.size();
+
+	// Both contacts' lists are sorted, so they are simply merged to find out
+	// the beginning, staying and ending contacts. The contacts of the removed entities
+	// are skipped, since their SmartIds are never valid again
+	auto sendEvent = [this](const std::pair<SmartId, SmartId>& contact, ECollisionEvent evt)
+	{
+		CPhysicalEntity* pEntity1 = GetEntity(contact.first);
+		CPhysicalEntity* pEntity2 = GetEntity(contact.second);
+		if (pEntity1 && pEntity2)
+		{
+			pEntity1->OnCollision(pEntity2->GetParentEntityId(), evt);
+			pEntity2->OnCollision(pEntity1->GetParentEntityId(), evt);
+		}
+	};
+
+	auto curr = m_contacts.begin();
+	auto prev = m_prevContacts.begin();
+	while (curr != m_contacts.end() || prev != m_prevContacts.end())
+	{
+		if (prev == m_prevContacts.end() || (curr != m_contacts.end() && *curr < *prev))
+		{
+			sendEvent(*curr++, ECollisionEvent_Begin);
+		}
+		else if (curr == m_contacts.end() || *prev < *curr)
+		{
+			sendEvent(*prev++, ECollisionEvent_End);
+		}
+		else
+		{
+			sendEvent(*curr++, ECollisionEvent_Stay);
+			++prev;
+		}
+	}
+
+	std::swap(m_contacts, m_prevContacts);
+
+	for (SmartId sid : m_fastEntities)
+	{
+		if (CPhysicalEntity* pEntity = GetEntity(sid))
+		{
+			pEntity->ResetSweep();
+		}
+	}
+
+	m_statistics.time = clock.getElapsedTime();
+}
+
+int CPhysicalSystem::QueryAABB(const sf::FloatRect& bounds, SmartId* pResults, int maxResults, uint32_t layerMask)
+{
+	UpdateDirtyEntities();
+
+	m_queryCandidates.clear();
+	m_pBroadphase->Query(bounds, m_queryCandidates);
+
+	int numResults = 0;
+	for (SmartId sid : m_queryCandidates)
 	{
-		for (int j = i + 1; j < m_entities.size(); ++j)
+		if (numResults >= maxResults)
 		{
-			const auto* pPhysics1 = m_entities[i].GetPhysics();
-			const auto* pPhysics2 = m_entities[j].GetPhysics();
+			break;
+		}
 
-			if (g_intersectionsTable[pPhysics1->GetType()][pPhysics2->GetType()](pPhysics1, pPhysics2))
+		const CPhysicalEntity* pEntity = GetEntity(sid);
+		if (pEntity && (pEntity->GetCollisionFilter().layer & layerMask) != 0 && pEntity->GetPhysics())
+		{
+			const sf::FloatRect& entityBounds = pEntity->GetPhysics()->GetBoundingBox();
+			if (entityBounds.left <= bounds.left + bounds.width && bounds.left <= entityBounds.left + entityBounds.width &&
+				entityBounds.top <= bounds.top + bounds.height && bounds.top <= entityBounds.top + entityBounds.height)
 			{
-				m_entities[i].OnCollision(m_entities[j].GetParentEntityId());
-				m_entities[j].OnCollision(m_entities[i].GetParentEntityId());
+				pResults[numResults++] = pEntity->GetParentEntityId();
 			}
 		}
 	}
+
+	return numResults;
+}
+
+int CPhysicalSystem::QueryRadius(const sf::Vector2f& vCenter, float fRadius, SmartId* pResults, int maxResults, uint32_t layerMask)
+{
+	UpdateDirtyEntities();
+
+	PhysicalPrimitive::Circle probe(vCenter, fRadius);
+
+	m_queryCandidates.clear();
+	m_pBroadphase->Query(probe.GetBoundingBox(), m_queryCandidates);
+
+	int numResults = 0;
+	for (SmartId sid : m_queryCandidates)
+	{
+		if (numResults >= maxResults)
+		{
+			break;
+		}
+
+		const CPhysicalEntity* pEntity = GetEntity(sid);
+		if (pEntity && (pEntity->GetCollisionFilter().layer & layerMask) != 0)
+		{
+			const auto* pPhysics = pEntity->GetPhysics();
+			if (pPhysics && g_intersectionsTable[PhysicalPrimitive::EPrimitiveType_Circle][pPhysics->GetType()](&probe, pPhysics))
+			{
+				pResults[numResults++] = pEntity->GetParentEntityId();
+			}
+		}
+	}
+
+	return numResults;
+}
+
+bool CPhysicalSystem::Raycast(const sf::Vector2f& vOrg, const sf::Vector2f& vDir, float fMaxDist, SRaycastHit& hit, uint32_t layerMask)
+{
+	UpdateDirtyEntities();
+
+	sf::Vector2f vDirection = MathHelpers::Normalize(vDir);
+	sf::Vector2f vEnd = vOrg + vDirection * fMaxDist;
+	sf::FloatRect bounds(std::min(vOrg.x, vEnd.x), std::min(vOrg.y, vEnd.y), std::abs(vEnd.x - vOrg.x), std::abs(vEnd.y - vOrg.y));
+
+	m_queryCandidates.clear();
+	m_pBroadphase->Query(bounds, m_queryCandidates);
+
+	bool bHit = false;
+	for (SmartId sid : m_queryCandidates)
+	{
+		const CPhysicalEntity* pEntity = GetEntity(sid);
+		if (pEntity && (pEntity->GetCollisionFilter().layer & layerMask) != 0)
+		{
+			float fDist;
+			const auto* pPhysics = pEntity->GetPhysics();
+			if (pPhysics && g_raycastTable[pPhysics->GetType()](pPhysics, vOrg, vDirection, fMaxDist, fDist))
+			{
+				// The closer hits are searched only
+				fMaxDist = fDist;
+				hit.entityId = pEntity->GetParentEntityId();
+				hit.fDistance = fDist;
+				hit.vPoint = vOrg + vDirection * fDist;
+				bHit = true;
+			}
+		}
+	}
+
+	return bHit;
 }
\ No newline at end of file
@@ -1,18 +1,30 @@
 #pragma once
 
 #include "PhysicalEntity.h"
+#include "Broadphase.h"
 #include "ConfigurationSystem/EntityConfiguration.h"
 
+#include <memory>
+#include <vector>
+#include <utility>
+
+#include <SFML/System/Time.hpp>
+
 /**
  * @class CPhysicalSystem
  * That system simply contains all the physical entities
- * and computes collisions between them.
+ * and computes collisions between them. The collision candidates
+ * are found by the broadphase (see IBroadphase), chosen by the physics configuration.
+ * The entities' transform changes are deferred: the world primitives and
+ * the broadphase proxies of the changed entities are updated once per frame,
+ * right before the collisions' processing or the spatial queries.
  */
 class CPhysicalSystem : public CEntitySystem <CPhysicalEntity, false>
 {
 public:
 
-	CPhysicalSystem() : CEntitySystem(128) {}
+	CPhysicalSystem();
+	~CPhysicalSystem();
 
 	/**
 	 * @function CreateEntityWithPrimitive
@@ -21,9 +33,143 @@ public:
 	 * 
 	 * @param type - physical primitive type code.
 	 * @param pConfig - physical primitive configuration.
+	 * @param filter - collision layer and mask of the entity.
+	 * @param bFast - whether the entity should be checked continuously (see CPhysicalEntity).
 	 * @return SmartId of the created entity.
 	 */
-	SmartId CreateEntityWithPrimitive(PhysicalPrimitive::EPrimitiveType type, const CEntityConfiguration::IPrimitiveConfig* pConfig);
+	SmartId CreateEntityWithPrimitive(PhysicalPrimitive::EPrimitiveType type, const CEntityConfiguration::IPrimitiveConfig* pConfig,
+		const SCollisionFilter& filter = SCollisionFilter(), bool bFast = false);
+
+	/**
+	 * @function OnEntityTransformChanged
+	 * Set the new entity transform and mark the entity as dirty.
+	 *
+	 * @param sid - SmartId of the physical entity.
+	 * @param transform - the new entity transform.
+	 */
+	void OnEntityTransformChanged(SmartId sid, const sf::Transform& transform);
+
+	/**
+	 * @function RemoveEntity
+	 * Override of the CEntitySystem method. Also removes the entity from the broadphase.
+	 */
+	virtual void RemoveEntity(SmartId sid, bool immediate = false) override;
+
+	/**
+	 * @function RecycleEntity
+	 * Take the entity out of the simulation, so it can be reused later without
+	 * creating the new primitives. The entity gets the new SmartId, the old one
+	 * becomes invalid, so the entity's contacts are dropped as on the removal.
+	 * 
+	 * @param sid - SmartId of the entity.
+	 * @return The new SmartId of the recycled entity.
+	 */
+	SmartId RecycleEntity(SmartId sid);
 
+	/**
+	 * @function RestoreEntity
+	 * Return the recycled entity into the simulation in the initial pose.
+	 * 
+	 * @param sid - SmartId of the recycled entity.
+	 */
+	void RestoreEntity(SmartId sid);
+
+	/**
+	 * @function Clear
+	 * Override of the CEntitySystem method. Also clears the broadphase.
+	 */
+	virtual void Clear() override;
+
+	/**
+	 * @function ProcessCollisions
+	 * Find all the intersecting entities and send them the collision events.
+	 * Should be called each frame. The sweeps of the fast entities start from here.
+	 * The candidate pairs are tested on the thread pool, but the events are sent
+	 * from the calling thread in the order of the entities' SmartIds.
+	 * The contacts are compared with the previous frame ones to send
+	 * the begin, stay and end events (see IPhysicalEventListener).
+	 */
 	void ProcessCollisions();
+
+	/**
+	 * @function QueryAABB
+	 * Find the entities, which bounding boxes overlap the specified bounds.
+	 * 
+	 * @param bounds - the query bounds.
+	 * @param pResults - the buffer for SmartIds of the found entities' parent (logical) entities.
+	 * @param maxResults - size of the buffer. The rest of the entities are not reported.
+	 * @param layerMask - the collision layers to search in (see SCollisionFilter).
+	 * @return The number of the entities written into the buffer.
+	 */
+	int QueryAABB(const sf::FloatRect& bounds, SmartId* pResults, int maxResults, uint32_t layerMask = ~0u);
+
+	/**
+	 * @function QueryRadius
+	 * Find the entities intersecting the circle. The parameters are the same as in QueryAABB.
+	 */
+	int QueryRadius(const sf::Vector2f& vCenter, float fRadius, SmartId* pResults, int maxResults, uint32_t layerMask = ~0u);
+
+	struct SRaycastHit
+	{
+		SmartId entityId = InvalidLink; // the parent (logical) entity
+		float fDistance = 0.f;
+		sf::Vector2f vPoint;
+	};
+
+	/**
+	 * @function Raycast
+	 * Find the first entity hit by the ray.
+	 * 
+	 * @param vOrg - origin of the ray.
+	 * @param vDir - direction of the ray.
+	 * @param fMaxDist - length of the ray.
+	 * @param hit - output hit description.
+	 * @param layerMask - the collision layers to search in (see SCollisionFilter).
+	 * @return True if any entity is hit.
+	 */
+	bool Raycast(const sf::Vector2f& vOrg, const sf::Vector2f& vDir, float fMaxDist, SRaycastHit& hit, uint32_t layerMask = ~0u);
+
+	struct SStatistics
+	{
+		int numCandidates = 0;
+		int numRejected = 0;
+		int numCollisions = 0; // number of the current contacts
+		sf::Time time;
+	};
+
+	// Statistics of the last ProcessCollisions call to compare the broadphase methods.
+	// The rejected candidates are the ones discarded by the primitives' bounds.
+	const SStatistics& GetStatistics() const { return m_statistics; }
+
+private:
+
+	// Rebuild the world primitives and the broadphase proxies of the dirty entities
+	void UpdateDirtyEntities();
+
+	// Rebuild the world primitive and the sweep of the entity if it's dirty
+	void UpdateWorldPrimitive(CPhysicalEntity& entity) const;
+
+private:
+
+	std::unique_ptr<IBroadphase> m_pBroadphase;
+	std::vector<std::pair<SmartId, SmartId>> m_candidates;
+
+	// Each thread of the narrow phase writes only into it's own buffer
+	struct alignas(64) SContactBuffer
+	{
+		std::vector<std::pair<SmartId, SmartId>> contacts;
+		int numRejected = 0;
+	};
+
+	std::vector<SContactBuffer> m_contactBuffers;
+	std::vector<std::pair<SmartId, SmartId>> m_contacts;
+	std::vector<std::pair<SmartId, SmartId>> m_prevContacts;
+
+	std::vector<SmartId> m_queryCandidates;
+
+	std::vector<SmartId> m_fastEntities;
+	std::vector<SmartId> m_dirtyEntities;
+	float m_fMaxSweepLength = 0.f;
+
+	SStatistics m_statistics;
 };
\ No newline at end of file
@@ -0,0 +1,239 @@
+#include "StdAfx.h"
+#include "SweepAndPrune.h"
+
+#include <algorithm>
+#include <cfloat>
+
+static inline float GetMin(const sf::FloatRect& bounds, int axis)
+{
+	return axis == 0 ? bounds.left : bounds.top;
+}
+
+static inline float GetMax(const sf::FloatRect& bounds, int axis)
+{
+	return axis == 0 ? bounds.left + bounds.width : bounds.top + bounds.height;
+}
+
+bool CSweepAndPrune::Less(const SEndpoint& e1, const SEndpoint& e2)
+{
+	// The touching intervals are considered as overlapping,
+	// so the min endpoints go first if the values are equal
+	return e1.fValue < e2.fValue || (e1.fValue == e2.fValue && !e1.bMax && e2.bMax);
+}
+
+std::pair<SmartId, SmartId> CSweepAndPrune::MakePair(SmartId sid1, SmartId sid2)
+{
+	return std::make_pair(std::min(sid1, sid2), std::max(sid1, sid2));
+}
+
+bool CSweepAndPrune::OverlapProxies(SmartId sid1, SmartId sid2) const
+{
+	const SProxy& proxy1 = m_proxies[GetSmartIdIndex(sid1)];
+	const SProxy& proxy2 = m_proxies[GetSmartIdIndex(sid2)];
+	if (!proxy1.filter.Accepts(proxy2.filter))
+	{
+		return false;
+	}
+
+	return Overlap(proxy1.bounds, proxy2.bounds);
+}
+
+void CSweepAndPrune::SwapEndpoints(int axis, int idx1, int idx2)
+{
+	std::vector<SEndpoint>& endpoints = m_axes[axis];
+	std::swap(endpoints[idx1], endpoints[idx2]);
+	m_proxies[GetSmartIdIndex(endpoints[idx1].sid)].endpoints[axis][endpoints[idx1].bMax] = idx1;
+	m_proxies[GetSmartIdIndex(endpoints[idx2].sid)].endpoints[axis][endpoints[idx2].bMax] = idx2;
+}
+
+void CSweepAndPrune::MoveEndpointDown(int axis, int idx)
+{
+	std::vector<SEndpoint>& endpoints = m_axes[axis];
+	while (idx > 0 && Less(endpoints[idx], endpoints[idx - 1]))
+	{
+		const SEndpoint& endpoint = endpoints[idx];
+		const SEndpoint& other = endpoints[idx - 1];
+
+		if (!endpoint.bMax && other.bMax)
+		{
+			// The intervals start overlapping on this axis
+			if (OverlapProxies(endpoint.sid, other.sid))
+			{
+				m_pairs.insert(MakePair(endpoint.sid, other.sid));
+			}
+		}
+		else if (endpoint.bMax && !other.bMax)
+		{
+			// The intervals stop overlapping on this axis
+			m_pairs.erase(MakePair(endpoint.sid, other.sid));
+		}
+
+		SwapEndpoints(axis, idx, idx - 1);
+		--idx;
+	}
+}
+
+void CSweepAndPrune::MoveEndpointUp(int axis, int idx)
+{
+	std::vector<SEndpoint>& endpoints = m_axes[axis];
+	while (idx < (int)endpoints.size() - 1 && Less(endpoints[idx + 1], endpoints[idx]))
+	{
+		const SEndpoint& endpoint = endpoints[idx];
+		const SEndpoint& other = endpoints[idx + 1];
+
+		if (endpoint.bMax && !other.bMax)
+		{
+			if (OverlapProxies(endpoint.sid, other.sid))
+			{
+				m_pairs.insert(MakePair(endpoint.sid, other.sid));
+			}
+		}
+		else if (!endpoint.bMax && other.bMax)
+		{
+			m_pairs.erase(MakePair(endpoint.sid, other.sid));
+		}
+
+		SwapEndpoints(axis, idx, idx + 1);
+		++idx;
+	}
+}
+
+CSweepAndPrune::SProxy* CSweepAndPrune::GetProxy(SmartId sid)
+{
+	int idx = GetSmartIdIndex(sid);
+	if (sid >= 0 && idx < m_proxies.size() && m_proxies[idx].bValid && m_proxies[idx].sid == sid)
+	{
+		return &m_proxies[idx];
+	}
+	return nullptr;
+}
+
+void CSweepAndPrune::MoveProxy(SmartId sid, const sf::FloatRect& bounds)
+{
+	SProxy& proxy = m_proxies[GetSmartIdIndex(sid)];
+	proxy.bounds = bounds;
+	m_fMaxExtent = std::max(m_fMaxExtent, bounds.width);
+
+	for (int axis = 0; axis < EAxis_Num; ++axis)
+	{
+		m_axes[axis][proxy.endpoints[axis][0]].fValue = GetMin(bounds, axis);
+		m_axes[axis][proxy.endpoints[axis][1]].fValue = GetMax(bounds, axis);
+
+		// The endpoints of the same proxy block each other, so the leading one
+		// is moved first: the max endpoint while moving up and the min one while moving down
+		MoveEndpointUp(axis, proxy.endpoints[axis][1]);
+		MoveEndpointUp(axis, proxy.endpoints[axis][0]);
+		MoveEndpointDown(axis, proxy.endpoints[axis][0]);
+		MoveEndpointDown(axis, proxy.endpoints[axis][1]);
+	}
+}
+
+void CSweepAndPrune::AddProxy(SmartId sid, const sf::FloatRect& bounds, const SCollisionFilter& filter)
+{
+	if (sid < 0)
+	{
+		return;
+	}
+
+	int idx = GetSmartIdIndex(sid);
+	if (idx >= m_proxies.size())
+	{
+		m_proxies.resize(idx + 1);
+	}
+
+	// The slot could still be occupied by the proxy with the same SmartId
+	// or by the proxy of the removed entity with the older generation
+	if (m_proxies[idx].bValid)
+	{
+		RemoveProxy(m_proxies[idx].sid);
+	}
+
+	// The new proxy is placed in the end of the axes and then
+	// moved to the right place as any other proxy
+	SProxy& proxy = m_proxies[idx];
+	proxy.sid = sid;
+	proxy.bValid = true;
+	proxy.filter = filter;
+	proxy.bounds = sf::FloatRect(FLT_MAX, FLT_MAX, 0.f, 0.f);
+
+	for (int axis = 0; axis < EAxis_Num; ++axis)
+	{
+		proxy.endpoints[axis][0] = (int)m_axes[axis].size();
+		m_axes[axis].push_back(SEndpoint{ FLT_MAX, sid, false });
+		proxy.endpoints[axis][1] = (int)m_axes[axis].size();
+		m_axes[axis].push_back(SEndpoint{ FLT_MAX, sid, true });
+	}
+
+	MoveProxy(sid, bounds);
+}
+
+void CSweepAndPrune::UpdateProxy(SmartId sid, const sf::FloatRect& bounds)
+{
+	if (GetProxy(sid))
+	{
+		MoveProxy(sid, bounds);
+	}
+}
+
+void CSweepAndPrune::RemoveProxy(SmartId sid)
+{
+	SProxy* pProxy = GetProxy(sid);
+	if (!pProxy)
+	{
+		return;
+	}
+
+	// Moving the proxy to the end of the axes removes all it's pairs,
+	// after which the endpoints can be simply dropped
+	MoveProxy(sid, sf::FloatRect(FLT_MAX, FLT_MAX, 0.f, 0.f));
+
+	for (int axis = 0; axis < EAxis_Num; ++axis)
+	{
+		std::vector<SEndpoint>& endpoints = m_axes[axis];
+		for (int i = 0; i < 2; ++i)
+		{
+			int idx = pProxy->endpoints[axis][1 - i];
+			if (idx != (int)endpoints.size() - 1)
+			{
+				SwapEndpoints(axis, idx, (int)endpoints.size() - 1);
+			}
+			endpoints.pop_back();
+		}
+	}
+
+	pProxy->bValid = false;
+}
+
+void CSweepAndPrune::Clear()
+{
+	for (auto& axis : m_axes)
+	{
+		axis.clear();
+	}
+	m_proxies.clear();
+	m_pairs.clear();
+	m_fMaxExtent = 0.f;
+}
+
+void CSweepAndPrune::CollectPairs(std::vector<std::pair<SmartId, SmartId>>& pairs)
+{
+	pairs.assign(m_pairs.begin(), m_pairs.end());
+}
+
+void CSweepAndPrune::Query(const sf::FloatRect& bounds, std::vector<SmartId>& results)
+{
+	const std::vector<SEndpoint>& endpoints = m_axes[EAxis_X];
+
+	// Each proxy overlapping the bounds starts not earlier than the maximal extent before them
+	float fStart = bounds.left - m_fMaxExtent;
+	auto iter = std::lower_bound(endpoints.begin(), endpoints.end(), fStart,
+		[](const SEndpoint& endpoint, float fValue) { return endpoint.fValue < fValue; });
+
+	for (; iter != endpoints.end() && iter->fValue <= bounds.left + bounds.width; ++iter)
+	{
+		if (!iter->bMax && Overlap(m_proxies[GetSmartIdIndex(iter->sid)].bounds, bounds))
+		{
+			results.push_back(iter->sid);
+		}
+	}
+}
\ No newline at end of file
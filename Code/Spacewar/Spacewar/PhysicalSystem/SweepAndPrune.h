@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Broadphase.h"
+
+#include <set>
+#include <vector>
+#include <utility>
+
+/**
+ * @class CSweepAndPrune
+ * Persistent sweep-and-prune broadphase. The bounds of the proxies are projected
+ * on the both axes and kept in the sorted endpoints lists between the frames.
+ * Since the most of the objects move only a few units per frame, updating a proxy
+ * takes just a few swaps of the neighbouring endpoints. The overlapping pairs are
+ * cached and updated incrementally on these swaps, so the pairs are never rediscovered
+ * from scratch and collecting them doesn't depend on the number of the proxies.
+ * The pairs excluded by the collision filters are not cached at all.
+ */
+class CSweepAndPrune : public IBroadphase
+{
+public:
+
+	virtual void AddProxy(SmartId sid, const sf::FloatRect& bounds, const SCollisionFilter& filter) override;
+	virtual void UpdateProxy(SmartId sid, const sf::FloatRect& bounds) override;
+	virtual void RemoveProxy(SmartId sid) override;
+	virtual void Clear() override;
+
+	virtual void CollectPairs(std::vector<std::pair<SmartId, SmartId>>& pairs) override;
+
+	// The query walks the X axis endpoints in the range of the query bounds,
+	// extended by the maximal size of the proxies
+	virtual void Query(const sf::FloatRect& bounds, std::vector<SmartId>& results) override;
+
+private:
+
+	enum EAxis
+	{
+		EAxis_X = 0,
+		EAxis_Y,
+		EAxis_Num
+	};
+
+	struct SEndpoint
+	{
+		float fValue = 0.f;
+		SmartId sid = InvalidLink;
+		bool bMax = false;
+	};
+
+	struct SProxy
+	{
+		SmartId sid = InvalidLink;
+		sf::FloatRect bounds;
+		SCollisionFilter filter;
+		int endpoints[EAxis_Num][2] = {};
+		bool bValid = false;
+	};
+
+	// The proxies are indexed by the link indices of the SmartIds
+	SProxy* GetProxy(SmartId sid);
+
+	// Set the new bounds and restore the endpoints' order in both axes
+	void MoveProxy(SmartId sid, const sf::FloatRect& bounds);
+
+	void MoveEndpointDown(int axis, int idx);
+	void MoveEndpointUp(int axis, int idx);
+	void SwapEndpoints(int axis, int idx1, int idx2);
+
+	bool OverlapProxies(SmartId sid1, SmartId sid2) const;
+
+	static bool Less(const SEndpoint& e1, const SEndpoint& e2);
+	static std::pair<SmartId, SmartId> MakePair(SmartId sid1, SmartId sid2);
+
+private:
+
+	std::vector<SEndpoint> m_axes[EAxis_Num];
+	std::vector<SProxy> m_proxies;
+	std::set<std::pair<SmartId, SmartId>> m_pairs;
+
+	// The maximal width of the proxies, it never shrinks until the Clear call
+	float m_fMaxExtent = 0.f;
+};
\ No newline at end of file
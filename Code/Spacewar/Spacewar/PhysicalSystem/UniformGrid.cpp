@@ -0,0 +1,74 @@
+#include "StdAfx.h"
+#include "UniformGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+
+void CUniformGrid::Reset(float fLevelSize, float fCellSize)
+{
+	for (int cell : m_usedCells)
+	{
+		m_cells[cell].clear();
+	}
+	m_usedCells.clear();
+
+	if (fLevelSize != m_fLevelSize || fCellSize != m_fDesiredCellSize)
+	{
+		m_fLevelSize = fLevelSize;
+		m_fDesiredCellSize = fCellSize;
+
+		// Without the level bounds the whole world is a single cell
+		if (fLevelSize > 0.f)
+		{
+			m_dNumCellsInRow = std::max(1, (int)ceilf(fLevelSize / std::max(fCellSize, 1.f)));
+			m_fCellSize = fLevelSize / m_dNumCellsInRow;
+		}
+		else
+		{
+			m_dNumCellsInRow = 1;
+			m_fCellSize = FLT_MAX;
+		}
+		m_cells.resize(m_dNumCellsInRow * m_dNumCellsInRow);
+	}
+}
+
+int CUniformGrid::GetCell(float coord) const
+{
+	return (int)floorf(coord / m_fCellSize);
+}
+
+void CUniformGrid::Insert(int idx, const sf::FloatRect& bounds, const SCollisionFilter& filter)
+{
+	ForEachCell(bounds, [&](int cell)
+		{
+			if (m_cells[cell].empty())
+			{
+				m_usedCells.push_back(cell);
+			}
+			m_cells[cell].push_back(SItem{ idx, filter });
+		});
+}
+
+void CUniformGrid::CollectPairs(std::vector<std::pair<int, int>>& pairs) const
+{
+	pairs.clear();
+
+	for (int cell : m_usedCells)
+	{
+		const std::vector<SItem>& objects = m_cells[cell];
+		for (int i = 0; i < objects.size(); ++i)
+		{
+			for (int j = i + 1; j < objects.size(); ++j)
+			{
+				if (objects[i].filter.Accepts(objects[j].filter))
+				{
+					pairs.emplace_back(std::min(objects[i].idx, objects[j].idx), std::max(objects[i].idx, objects[j].idx));
+				}
+			}
+		}
+	}
+
+	std::sort(pairs.begin(), pairs.end());
+	pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+}
\ No newline at end of file
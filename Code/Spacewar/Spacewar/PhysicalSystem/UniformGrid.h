@@ -0,0 +1,126 @@
+#pragma once
+
+#include "CollisionFilter.h"
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include <SFML/Graphics/Rect.hpp>
+
+/**
+ * @class CUniformGrid
+ * Collisions' broadphase splitting the level into the equal square cells.
+ * The grid is toroidal as well as the level itself, so the objects crossing
+ * the level boundaries are placed into the cells on the opposite side.
+ * The grid is refilled every frame, only the objects sharing a cell
+ * are considered as the collision candidates, unless their collision filters exclude each other.
+ */
+class CUniformGrid
+{
+public:
+
+	CUniformGrid() = default;
+	CUniformGrid(const CUniformGrid&) = delete;
+
+	/**
+	 * @function Reset
+	 * Remove all the objects from the grid and rebuild the cells if the level
+	 * or the cell size has been changed.
+	 *
+	 * @param fLevelSize - length of the level's square side. If the level size is not positive,
+	 * the grid consists of the only cell.
+	 * @param fCellSize - desired length of the cell's side. The actual size
+	 * is adjusted to fit the level size by the whole number of cells.
+	 */
+	void Reset(float fLevelSize, float fCellSize);
+
+	/**
+	 * @function Insert
+	 * Put the object into all the cells overlapped by it's bounding box.
+	 *
+	 * @param idx - index of the object which is returned in the candidate pairs.
+	 * @param bounds - world bounding box of the object.
+	 * @param filter - collision filter of the object.
+	 */
+	void Insert(int idx, const sf::FloatRect& bounds, const SCollisionFilter& filter);
+
+	/**
+	 * @function CollectPairs
+	 * Find all the pairs of the objects sharing at least one cell and accepted by the collision filters.
+	 *
+	 * @param pairs - output pairs of the objects' indices. The first index in the
+	 * pair is always less than the second one, the pairs are sorted and unique.
+	 */
+	void CollectPairs(std::vector<std::pair<int, int>>& pairs) const;
+
+	/**
+	 * @function Query
+	 * Visit all the objects in the cells overlapped by the bounds.
+	 * The object is visited once for each shared cell.
+	 *
+	 * @param bounds - world bounding box of the query.
+	 * @param fn - function taking the index of the object.
+	 */
+	template <typename Fn>
+	void Query(const sf::FloatRect& bounds, Fn&& fn) const
+	{
+		ForEachCell(bounds, [&](int cell)
+			{
+				for (const SItem& item : m_cells[cell])
+				{
+					fn(item.idx);
+				}
+			});
+	}
+
+private:
+
+	struct SItem
+	{
+		int idx;
+		SCollisionFilter filter;
+	};
+
+	int GetCell(float coord) const;
+
+	// Visit all the cells overlapped by the bounds
+	template <typename Fn>
+	void ForEachCell(const sf::FloatRect& bounds, Fn&& fn) const
+	{
+		if (m_dNumCellsInRow == 0)
+		{
+			return;
+		}
+
+		int minX = GetCell(bounds.left);
+		int minY = GetCell(bounds.top);
+		int numX = std::min(GetCell(bounds.left + bounds.width) - minX + 1, m_dNumCellsInRow);
+		int numY = std::min(GetCell(bounds.top + bounds.height) - minY + 1, m_dNumCellsInRow);
+
+		auto wrap = [this](int cell)
+		{
+			cell %= m_dNumCellsInRow;
+			return cell < 0 ? cell + m_dNumCellsInRow : cell;
+		};
+
+		for (int i = 0; i < numX; ++i)
+		{
+			int x = wrap(minX + i);
+			for (int j = 0; j < numY; ++j)
+			{
+				fn(wrap(minY + j) * m_dNumCellsInRow + x);
+			}
+		}
+	}
+
+private:
+
+	int m_dNumCellsInRow = 0;
+	float m_fLevelSize = 0.f;
+	float m_fDesiredCellSize = 0.f;
+	float m_fCellSize = 0.f;
+
+	std::vector<std::vector<SItem>> m_cells;
+	std::vector<int> m_usedCells;
+};
\ No newline at end of file
@@ -1,9 +1,10 @@
 #include "StdAfx.h"
 #include "RenderEntity.h"
 
-CRenderEntity::CRenderEntity(ERenderObjectType type)
+CRenderEntity::CRenderEntity(ERenderObjectType type, ERenderLayer layer)
 {
 	m_type = type;
+	m_layer = layer;
 	switch (m_type)
 	{
 	case Sprite:
@@ -201,12 +202,49 @@ const sf::Vector2f CRenderEntity::GetSize() const
 	return sf::Vector2f(rect.width, rect.height);
 }
 
-void CRenderEntity::Render(sf::RenderTarget& target) const
+void CRenderEntity::SetTransform(const sf::Transform& transform, int tick)
 {
-	if (m_pRenderObject)
+	// The entity is moved once per tick at most, except the changes applied between the ticks
+	if (!m_bHasTransform || tick != m_dTick)
+	{
+		m_prevTransform = m_bHasTransform ? m_transform : transform;
+	}
+	m_transform = transform;
+	m_dTick = tick;
+	m_bHasTransform = true;
+
+	// Anything moving farther in a tick has been placed rather than moved
+	constexpr float MaxInterpolatedDistance = 100.f;
+	sf::Vector2f vOffset = m_transform.transformPoint(0.f, 0.f) - m_prevTransform.transformPoint(0.f, 0.f);
+	if (vOffset.x * vOffset.x + vOffset.y * vOffset.y > MaxInterpolatedDistance * MaxInterpolatedDistance)
+	{
+		m_prevTransform = m_transform;
+	}
+}
+
+sf::Transform CRenderEntity::GetInterpolatedTransform(int tick, float fAlpha) const
+{
+	if (tick != m_dTick || fAlpha >= 1.f)
+	{
+		return m_transform;
+	}
+
+	// The affine matrices are blended componentwise, the rotation per tick is small enough for it
+	const float* prev = m_prevTransform.getMatrix();
+	const float* cur = m_transform.getMatrix();
+	auto lerp = [fAlpha, prev, cur](int i) { return prev[i] + (cur[i] - prev[i]) * fAlpha; };
+
+	return sf::Transform(lerp(0), lerp(4), lerp(12),
+		lerp(1), lerp(5), lerp(13),
+		0.f, 0.f, 1.f);
+}
+
+void CRenderEntity::Render(sf::RenderTarget& target, int tick, float fAlpha) const
+{
+	if (m_pRenderObject && m_bVisible)
 	{
 		sf::RenderStates states;
-		states.transform = m_transform;
+		states.transform = GetInterpolatedTransform(tick, fAlpha);
 		target.draw(*m_pRenderObject, states);
 	}
 }
\ No newline at end of file
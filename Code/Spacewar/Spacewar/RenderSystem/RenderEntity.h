@@ -28,8 +28,15 @@ public:
 		Text
 	};
 
+	// The UI layer is drawn over the world one (see CRenderSystem::Render)
+	enum ERenderLayer : uint8_t
+	{
+		World,
+		UI
+	};
+
 	CRenderEntity() = default;
-	CRenderEntity(ERenderObjectType type);
+	CRenderEntity(ERenderObjectType type, ERenderLayer layer = World);
 
 	
 	// Sprite
@@ -50,14 +57,42 @@ public:
 	const sf::Font* GetFont() const;
 	
 	// Shared
-	void SetTransform(const sf::Transform& transform) { m_transform = transform; }
+
+	/**
+	 * @function SetTransform
+	 * Set the transform of the simulation tick. The entity keeps the transforms
+	 * of the last two ticks and is rendered between them (see GetInterpolatedTransform).
+	 * The new entities and the long jumps (teleports, wrapping around the level) are not interpolated.
+	 *
+	 * @param transform - new transform.
+	 * @param tick - number of the render system's tick (see CRenderSystem::NextTick),
+	 *               could be omitted for the entities which are placed only once.
+	 */
+	void SetTransform(const sf::Transform& transform, int tick = 0);
 	void SetColor(const sf::Color color);
 
 	const sf::Transform& GetTransform() const { return m_transform; }
+
+	/**
+	 * @function GetInterpolatedTransform
+	 * Blend the transforms of the previous and the last ticks.
+	 * The entities, which haven't moved in the last tick, stay at their transforms.
+	 *
+	 * @param tick - number of the last tick.
+	 * @param fAlpha - time passed since the last tick in the ticks, in [0, 1].
+	 * @return The transform to render the entity with.
+	 */
+	sf::Transform GetInterpolatedTransform(int tick, float fAlpha) const;
 	sf::Color GetColor() const;
 	const sf::Vector2f GetSize() const;
 
-	void Render(sf::RenderTarget& target) const;
+	// The hidden entities are not rendered, but keep all their properties
+	void SetVisible(bool bVisible) { m_bVisible = bVisible; }
+	bool IsVisible() const { return m_bVisible; }
+
+	ERenderLayer GetLayer() const { return m_layer; }
+
+	void Render(sf::RenderTarget& target, int tick, float fAlpha) const;
 
 private:
 
@@ -69,5 +104,10 @@ private:
 
 	std::unique_ptr<sf::Drawable> m_pRenderObject;
 	ERenderObjectType m_type;
+	ERenderLayer m_layer = World;
 	sf::Transform m_transform;
+	sf::Transform m_prevTransform;
+	int m_dTick = 0;
+	bool m_bHasTransform = false;
+	bool m_bVisible = true;
 };
\ No newline at end of file
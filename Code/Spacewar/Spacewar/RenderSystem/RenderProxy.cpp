@@ -41,15 +41,25 @@ void CRenderProxy::ExecuteCommands()
 		case RenderCommand::ERenderCommand_SetFont:
 			m_memoryStreams[m_dReadStream].Extract<RenderCommand::SetFontCommand>().Execute();
 			break;
+		case RenderCommand::ERenderCommand_SetVisible:
+			m_memoryStreams[m_dReadStream].Extract<RenderCommand::SetVisibleCommand>().Execute();
+			break;
+		case RenderCommand::ERenderCommand_NextTick:
+			m_memoryStreams[m_dReadStream].Extract<RenderCommand::NextTickCommand>().Execute();
+			break;
+		case RenderCommand::ERenderCommand_SetInterpolation:
+			m_memoryStreams[m_dReadStream].Extract<RenderCommand::SetInterpolationCommand>().Execute();
+			break;
 		}
 	}
 }
 
 void RenderCommand::SetTransformCommand::Execute() const
 {
-	if (CRenderEntity* pRenderEntity = CGame::Get().GetRenderSystem()->GetEntity(sid))
+	CRenderSystem* pRenderSystem = CGame::Get().GetRenderSystem();
+	if (CRenderEntity* pRenderEntity = pRenderSystem->GetEntity(sid))
 	{
-		pRenderEntity->SetTransform(transform);
+		pRenderEntity->SetTransform(transform, pRenderSystem->GetTick());
 	}
 }
 
@@ -105,6 +115,14 @@ void RenderCommand::SetCharacterSizeCommand::Execute() const
 	}
 }
 
+void RenderCommand::SetVisibleCommand::Execute() const
+{
+	if (CRenderEntity* pRenderEntity = CGame::Get().GetRenderSystem()->GetEntity(sid))
+	{
+		pRenderEntity->SetVisible(bVisible);
+	}
+}
+
 void RenderCommand::SetFontCommand::Execute() const
 {
 	if (CRenderEntity* pRenderEntity = CGame::Get().GetRenderSystem()->GetEntity(sid))
@@ -114,4 +132,14 @@ void RenderCommand::SetFontCommand::Execute() const
 			pRenderEntity->SetFont(*pFont);
 		}
 	}
+}
+
+void RenderCommand::NextTickCommand::Execute() const
+{
+	CGame::Get().GetRenderSystem()->NextTick();
+}
+
+void RenderCommand::SetInterpolationCommand::Execute() const
+{
+	CGame::Get().GetRenderSystem()->SetInterpolation(fAlpha);
 }
\ No newline at end of file
@@ -17,7 +17,10 @@ namespace RenderCommand
 		ERenderCommand_SetText,
 		ERenderCommand_SetStyle,
 		ERenderCommand_SetCharacterSize,
-		ERenderCommand_SetFont
+		ERenderCommand_SetFont,
+		ERenderCommand_SetVisible,
+		ERenderCommand_NextTick,
+		ERenderCommand_SetInterpolation
 	};
 
 	struct RenderCommand
@@ -125,6 +128,39 @@ namespace RenderCommand
 
 		int fontId;
 	};
+
+	struct SetVisibleCommand : public RenderCommand
+	{
+		SetVisibleCommand(SmartId _sid, bool _bVisible)
+			: RenderCommand(_sid), bVisible(_bVisible) {}
+
+		static constexpr ERenderCommand GetType() { return ERenderCommand_SetVisible; }
+		virtual void Execute() const override;
+
+		bool bVisible;
+	};
+
+	// The commands of the render system itself are created with the invalid SmartId
+
+	struct NextTickCommand : public RenderCommand
+	{
+		NextTickCommand(SmartId _sid)
+			: RenderCommand(_sid) {}
+
+		static constexpr ERenderCommand GetType() { return ERenderCommand_NextTick; }
+		virtual void Execute() const override;
+	};
+
+	struct SetInterpolationCommand : public RenderCommand
+	{
+		SetInterpolationCommand(SmartId _sid, float _fAlpha)
+			: RenderCommand(_sid), fAlpha(_fAlpha) {}
+
+		static constexpr ERenderCommand GetType() { return ERenderCommand_SetInterpolation; }
+		virtual void Execute() const override;
+
+		float fAlpha;
+	};
 }
 
 /**
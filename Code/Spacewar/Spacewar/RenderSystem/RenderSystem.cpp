@@ -4,10 +4,43 @@
 #include "ResourceSystem.h"
 
 void CRenderSystem::Render(sf::RenderTarget& target)
+{
+	RenderLayer(target, CRenderEntity::World);
+
+	// The bullets are drawn over the world entities, but under the UI
+	for (const auto& [textureId, vertices] : m_spriteBatches[1 - m_dWriteBatches])
+	{
+		if (!vertices.empty())
+		{
+			if (const sf::Texture* pTexture = LoadTexture(textureId))
+			{
+				target.draw(vertices.data(), vertices.size(), sf::Quads, sf::RenderStates(pTexture));
+			}
+		}
+	}
+
+	RenderLayer(target, CRenderEntity::UI);
+}
+
+void CRenderSystem::RenderLayer(sf::RenderTarget& target, CRenderEntity::ERenderLayer layer)
 {
 	for (int i = 0; i < m_dNumActiveEntities; ++i)
 	{
-		m_entities[i].Render(target);
+		if (m_entities[i].GetLayer() == layer)
+		{
+			m_entities[i].Render(target, m_dTick, m_fAlpha);
+		}
+	}
+}
+
+void CRenderSystem::SwitchBatches()
+{
+	m_dWriteBatches = 1 - m_dWriteBatches;
+
+	// The vertex arrays keep their capacity, so the batches don't allocate in the steady state
+	for (auto& [textureId, vertices] : m_spriteBatches[m_dWriteBatches])
+	{
+		vertices.clear();
 	}
 }
 
@@ -1,11 +1,15 @@
 #pragma once
 
 #include "EntitySystem.h"
+#include "SegmentedVector.h"
 #include "RenderEntity.h"
 
 #include <unordered_map>
+#include <map>
+#include <vector>
 
 #include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Vertex.hpp>
 
 /**
  * @class CRenderSystem
@@ -16,9 +20,16 @@
  * of each frame is fixed and cannot be modifier until the next synchronization.
  * Besides it, main thread cannot "physically" delete entities from the system.
  * It can just unlink them so they will be deleted in the end of the frame.
+ * The entities are stored in the segmented container, so creating the new entities
+ * in the main thread never relocates the ones being rendered.
  * The render system also stores the textures instances, created in the video memory.
+ * The numerous objects without the render entities (like the bullets) are drawn
+ * with the sprite batches: the vertex arrays, which are double buffered in the same
+ * way as the render commands (see CRenderProxy) and drawn between the world and the UI layers.
+ * The entities are drawn between their poses of the last two simulation ticks,
+ * the ticks and the blending factor are passed with the render commands.
  */
-class CRenderSystem : public CEntitySystem<CRenderEntity, true>
+class CRenderSystem : public CEntitySystem<CRenderEntity, true, CSegmentedVector<CRenderEntity, 256, 256>>
 {
 public:
 
@@ -28,11 +39,46 @@ public:
 	
 	const sf::Texture* LoadTexture(int id);
 
+	/**
+	 * @function GetSpriteBatch
+	 * Get the quads' vertices of the writing batch of the texture. The batch
+	 * is drawn in one call on the next frame. The texture coordinates are in pixels.
+	 * Should be called from one of the frame's tasks at a time, the batches are switched
+	 * on the main thread under the render lock after the frame's tasks are done.
+	 * The batch's address is stable.
+	 * 
+	 * @param textureId - resource id of the texture.
+	 * @return The vertex array of the batch, cleared on each batches' switch.
+	 */
+	std::vector<sf::Vertex>& GetSpriteBatch(int textureId) { return m_spriteBatches[m_dWriteBatches][textureId]; }
+
+	/**
+	 * @function SwitchBatches
+	 * This function is called from the main thread under the synchronization
+	 * together with CRenderProxy::SwitchStreams.
+	 */
+	void SwitchBatches();
+
+	// The simulation ticks counted on the render thread (see CRenderEntity::SetTransform)
+	void NextTick() { ++m_dTick; }
+	int GetTick() const { return m_dTick; }
+
+	// Time passed since the last tick in the ticks
+	void SetInterpolation(float fAlpha) { m_fAlpha = fAlpha; }
+
 	void Render(sf::RenderTarget& target);
 
 private:
 
+	void RenderLayer(sf::RenderTarget& target, CRenderEntity::ERenderLayer layer);
+
 	int m_dNumActiveEntities = 0;
 
+	int m_dTick = 0;
+	float m_fAlpha = 1.f;
+
+	std::map<int, std::vector<sf::Vertex>> m_spriteBatches[2];
+	int m_dWriteBatches = 0;
+
 	std::unordered_map<int, sf::Texture> m_textures;
 };
\ No newline at end of file
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <new>
+#include <memory>
+#include <utility>
+
+/**
+ * @class CSegmentedVector
+ * The array of the elements stored in the fixed size segments. The segments are
+ * allocated on demand and never released until the container is destroyed,
+ * so the elements never move in memory when the container grows.
+ * The table of the segments is fixed too, which allows one thread to access
+ * the existing elements while the other one is adding the new elements in the end.
+ * Implements the subset of the std::vector interface used by CEntitySystem.
+ *
+ * @template param T - type of the elements.
+ * @template param SegmentSize - number of the elements in a segment.
+ * @template param MaxSegments - maximal number of the segments.
+ */
+template <typename T, int SegmentSize, int MaxSegments = 1024>
+class CSegmentedVector
+{
+	static_assert((SegmentSize & (SegmentSize - 1)) == 0, "The segment size should be a power of two");
+
+	struct SSegment
+	{
+		alignas(T) unsigned char data[sizeof(T) * SegmentSize];
+	};
+
+public:
+
+	// The same storage of the elements of the other type
+	template <typename U>
+	using Rebind = CSegmentedVector<U, SegmentSize, MaxSegments>;
+
+	CSegmentedVector() = default;
+	CSegmentedVector(const CSegmentedVector&) = delete;
+	CSegmentedVector& operator=(const CSegmentedVector&) = delete;
+
+	~CSegmentedVector()
+	{
+		clear();
+	}
+
+	void reserve(size_t size)
+	{
+		for (size_t i = 0; i < (size + SegmentSize - 1) / SegmentSize && i < MaxSegments; ++i)
+		{
+			if (!m_segments[i])
+			{
+				m_segments[i] = std::make_unique<SSegment>();
+			}
+		}
+	}
+
+	size_t size() const { return m_size; }
+	size_t max_size() const { return (size_t)SegmentSize * MaxSegments; }
+	bool empty() const { return m_size == 0; }
+
+	T& operator[](size_t idx) { return *Get(idx); }
+	const T& operator[](size_t idx) const { return *Get(idx); }
+
+	T& back() { return *Get(m_size - 1); }
+
+	template <typename... V>
+	T& emplace_back(V&&... args)
+	{
+		std::unique_ptr<SSegment>& pSegment = m_segments[m_size / SegmentSize];
+		if (!pSegment)
+		{
+			pSegment = std::make_unique<SSegment>();
+		}
+
+		T* pElement = new (Get(m_size)) T(std::forward<V>(args)...);
+		++m_size;
+		return *pElement;
+	}
+
+	void pop_back()
+	{
+		--m_size;
+		Get(m_size)->~T();
+	}
+
+	void clear()
+	{
+		while (m_size > 0)
+		{
+			pop_back();
+		}
+	}
+
+private:
+
+	T* Get(size_t idx) const
+	{
+		return reinterpret_cast<T*>(m_segments[idx / SegmentSize]->data) + idx % SegmentSize;
+	}
+
+private:
+
+	std::unique_ptr<SSegment> m_segments[MaxSegments];
+	size_t m_size = 0;
+};
\ No newline at end of file
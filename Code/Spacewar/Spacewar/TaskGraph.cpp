@@ -0,0 +1,151 @@
+#include "StdAfx.h"
+#include "TaskGraph.h"
+#include "TaskScheduler.h"
+
+#include <thread>
+#include <chrono>
+
+int CTaskGraph::AddTask(const std::string& name, TaskFunction func, bool bMainThread)
+{
+	auto pNode = std::make_unique<SNode>();
+	pNode->pGraph = this;
+	pNode->index = (int)m_nodes.size();
+	pNode->name = name;
+	pNode->func = std::move(func);
+	pNode->bMainThread = bMainThread;
+	m_nodes.push_back(std::move(pNode));
+	return (int)m_nodes.size() - 1;
+}
+
+void CTaskGraph::AddDependency(int task, int dependency)
+{
+	if (task < 0 || task >= (int)m_nodes.size() || dependency < 0 || dependency >= task)
+	{
+		Log("Invalid dependency of the task ", task, " on the task ", dependency);
+		return;
+	}
+
+	m_nodes[dependency]->successors.push_back(task);
+	++m_nodes[task]->numDependencies;
+}
+
+void CTaskGraph::Schedule(int node)
+{
+	if (m_nodes[node]->bMainThread)
+	{
+		std::lock_guard<std::mutex> lock(m_mainLock);
+		m_mainThreadNodes.push_back(node);
+	}
+	else
+	{
+		m_pScheduler->Run(*m_pGroup, &CTaskGraph::ExecuteNode, m_nodes[node].get());
+	}
+}
+
+void CTaskGraph::ExecuteNode(void* pContext, int thread)
+{
+	SNode* pNode = static_cast<SNode*>(pContext);
+	pNode->pGraph->Execute(pNode->index);
+}
+
+void CTaskGraph::Execute(int node)
+{
+	SNode& task = *m_nodes[node];
+	Invoke(task);
+
+	for (int successor : task.successors)
+	{
+		if (--m_nodes[successor]->numPending == 0)
+		{
+			Schedule(successor);
+		}
+	}
+
+	--m_dNumRemaining;
+}
+
+void CTaskGraph::Invoke(SNode& task)
+{
+	auto start = std::chrono::steady_clock::now();
+	task.func();
+	task.time += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+void CTaskGraph::ResetTimes()
+{
+	for (auto& pNode : m_nodes)
+	{
+		pNode->time = 0;
+	}
+	m_dNumRuns = 0;
+	m_runTime = 0;
+}
+
+void CTaskGraph::Run(CTaskScheduler& scheduler, bool bSerial)
+{
+	auto start = std::chrono::steady_clock::now();
+	++m_dNumRuns;
+
+	if (bSerial)
+	{
+		// The loops of the tasks are run on the calling thread too, so the serial run is single-threaded
+		scheduler.SetSerial(true);
+		for (const auto& pNode : m_nodes)
+		{
+			Invoke(*pNode);
+		}
+		scheduler.SetSerial(false);
+
+		m_runTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+		return;
+	}
+
+	CTaskGroup group;
+	m_pScheduler = &scheduler;
+	m_pGroup = &group;
+	m_dNumRemaining = (int)m_nodes.size();
+
+	for (auto& pNode : m_nodes)
+	{
+		pNode->numPending = pNode->numDependencies;
+	}
+
+	for (int i = 0; i < (int)m_nodes.size(); ++i)
+	{
+		if (m_nodes[i]->numDependencies == 0)
+		{
+			Schedule(i);
+		}
+	}
+
+	// The calling thread runs it's own tasks and helps the workers with the rest
+	while (m_dNumRemaining.load() > 0)
+	{
+		int node = -1;
+		{
+			std::lock_guard<std::mutex> lock(m_mainLock);
+			if (!m_mainThreadNodes.empty())
+			{
+				node = m_mainThreadNodes.back();
+				m_mainThreadNodes.pop_back();
+			}
+		}
+
+		if (node != -1)
+		{
+			Execute(node);
+		}
+		else if (!scheduler.ProcessTask())
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	// The tasks have finished their bodies, but could still hold the group
+	scheduler.Wait(group);
+
+	m_pScheduler = nullptr;
+	m_pGroup = nullptr;
+
+	m_runTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
\ No newline at end of file
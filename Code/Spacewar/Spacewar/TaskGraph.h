@@ -0,0 +1,120 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <cstdint>
+
+#include <SFML/System/Time.hpp>
+
+class CTaskScheduler;
+class CTaskGroup;
+
+/**
+ * @class CTaskGraph
+ * The graph of the tasks with the dependencies between them, which is built once
+ * and run many times (e.g. each frame). The task is started when all the tasks
+ * it depends on are done, so the independent tasks overlap on the worker threads.
+ * The tasks which must be run on the thread running the graph (e.g. using the window)
+ * are never given to the workers. The graph could be run serially on the calling thread
+ * in the order of the tasks' addition to compare the results with the parallel run.
+ * The time spent in each task and in the whole runs is counted to compare the timings too.
+ */
+class CTaskGraph
+{
+public:
+
+	using TaskFunction = std::function<void()>;
+
+	CTaskGraph() = default;
+	CTaskGraph(const CTaskGraph&) = delete;
+
+	/**
+	 * @function AddTask
+	 * Add the task to the graph.
+	 *
+	 * @param name - name of the task for the debugging.
+	 * @param func - the task body.
+	 * @param bMainThread - if the task must be run on the thread running the graph.
+	 * @return index of the task.
+	 */
+	int AddTask(const std::string& name, TaskFunction func, bool bMainThread = false);
+
+	/**
+	 * @function AddDependency
+	 * Make the task wait for the other one. The order of the addition is the order
+	 * of the serial run, so the dependency must be added to the graph before the task.
+	 *
+	 * @param task - index of the dependent task.
+	 * @param dependency - index of the task to be waited for.
+	 */
+	void AddDependency(int task, int dependency);
+
+	/**
+	 * @function Run
+	 * Run all the tasks and wait until they are done.
+	 *
+	 * @param scheduler - task scheduler running the tasks.
+	 * @param bSerial - run the tasks one by one on the calling thread. The scheduler
+	 * doesn't give the tasks' loops to the workers either (see CTaskScheduler::SetSerial).
+	 */
+	void Run(CTaskScheduler& scheduler, bool bSerial);
+
+	int GetNumTasks() const { return (int)m_nodes.size(); }
+	const std::string& GetTaskName(int task) const { return m_nodes[task]->name; }
+
+	/**
+	 * @function GetTaskTime
+	 * Get the time spent in the task's body since the last reset. The tasks
+	 * overlapping in the parallel run are counted separately, so the sum
+	 * of the tasks' times could exceed the time of the runs.
+	 *
+	 * @param task - index of the task.
+	 */
+	sf::Time GetTaskTime(int task) const { return sf::microseconds(m_nodes[task]->time.load()); }
+
+	// The number of the runs and the time spent in them since the last reset
+	int GetNumRuns() const { return m_dNumRuns; }
+	sf::Time GetRunTime() const { return sf::microseconds(m_runTime); }
+
+	void ResetTimes();
+
+private:
+
+	struct SNode
+	{
+		CTaskGraph* pGraph = nullptr;
+		int index = 0;
+		std::string name;
+		TaskFunction func;
+		bool bMainThread = false;
+		std::vector<int> successors;
+		int numDependencies = 0;
+		std::atomic<int> numPending = 0;
+		std::atomic<int64_t> time = 0; // in microseconds
+	};
+
+	void Schedule(int node);
+	void Execute(int node);
+	void Invoke(SNode& task);
+
+	// The scheduler's task body, the context is the node
+	static void ExecuteNode(void* pContext, int thread);
+
+private:
+
+	std::vector<std::unique_ptr<SNode>> m_nodes;
+
+	int m_dNumRuns = 0;
+	int64_t m_runTime = 0; // in microseconds
+
+	// The state of the current run
+	CTaskScheduler* m_pScheduler = nullptr;
+	CTaskGroup* m_pGroup = nullptr;
+	std::atomic<int> m_dNumRemaining = 0;
+	std::mutex m_mainLock;
+	std::vector<int> m_mainThreadNodes;
+};
\ No newline at end of file
@@ -0,0 +1,298 @@
+#include "StdAfx.h"
+#include "TaskScheduler.h"
+
+#include <chrono>
+#include <algorithm>
+
+// The initial capacity of the threads' deques, it's doubled each time the deque is full
+static constexpr int InitialQueueSize = 256;
+
+// There is one scheduler in the game, so the thread's index is simply global
+static thread_local int s_dThreadIndex = -1;
+// The tasks executed while waiting inside the other tasks are not counted as the busy time twice
+static thread_local int s_dExecutionDepth = 0;
+
+CTaskScheduler::CTaskScheduler(int numWorkers)
+{
+	s_dThreadIndex = 0;
+
+	numWorkers = std::max(numWorkers, 0);
+	for (int i = 0; i < numWorkers + 1; ++i)
+	{
+		m_queues.push_back(std::make_unique<SQueue>());
+		m_queues.back()->tasks.resize(InitialQueueSize);
+	}
+
+	for (int i = 0; i < numWorkers; ++i)
+	{
+		m_workers.emplace_back(&CTaskScheduler::WorkerLoop, this, i + 1);
+	}
+}
+
+CTaskScheduler::~CTaskScheduler()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_sleepLock);
+		m_bStop = true;
+	}
+	m_wakeSync.notify_all();
+
+	for (auto& worker : m_workers)
+	{
+		worker.join();
+	}
+}
+
+int CTaskScheduler::GetThreadIndex() const
+{
+	return s_dThreadIndex;
+}
+
+void CTaskScheduler::SQueue::PushBack(const STask& task)
+{
+	const int capacity = (int)tasks.size();
+	if (size == capacity)
+	{
+		// The tasks are moved to the beginning of the bigger buffer in the same order
+		std::vector<STask> grown(std::max(2 * capacity, InitialQueueSize));
+		for (int i = 0; i < size; ++i)
+		{
+			grown[i] = tasks[(first + i) % capacity];
+		}
+		tasks.swap(grown);
+		first = 0;
+	}
+
+	tasks[(first + size) % tasks.size()] = task;
+	++size;
+}
+
+void CTaskScheduler::SQueue::PopBack(STask& task)
+{
+	--size;
+	task = tasks[(first + size) % tasks.size()];
+}
+
+void CTaskScheduler::SQueue::PopFront(STask& task)
+{
+	task = tasks[first];
+	first = (first + 1) % (int)tasks.size();
+	--size;
+}
+
+void CTaskScheduler::Push(int thread, const STask& task)
+{
+	++task.pGroup->m_dNumPending;
+
+	// The threads not belonging to the scheduler share the main thread's deque
+	SQueue& queue = *m_queues[thread >= 0 ? thread : 0];
+	{
+		std::lock_guard<std::mutex> lock(queue.lock);
+		queue.PushBack(task);
+	}
+
+	// The sleeping workers check the number of the queued tasks after they are counted
+	// as sleeping, so at least one of the sides sees the other's change
+	++m_dNumQueued;
+	if (m_dNumSleeping.load() > 0)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_sleepLock);
+		}
+		m_wakeSync.notify_one();
+	}
+}
+
+bool CTaskScheduler::Pop(int thread, STask& task)
+{
+	SQueue& queue = *m_queues[thread];
+	std::lock_guard<std::mutex> lock(queue.lock);
+	if (queue.size == 0)
+	{
+		return false;
+	}
+
+	queue.PopBack(task);
+	--m_dNumQueued;
+	return true;
+}
+
+bool CTaskScheduler::Steal(int thread, STask& task)
+{
+	const int numThreads = GetNumThreads();
+	for (int i = 1; i < numThreads; ++i)
+	{
+		SQueue& victim = *m_queues[(thread + i) % numThreads];
+		std::lock_guard<std::mutex> lock(victim.lock);
+		if (victim.size > 0)
+		{
+			victim.PopFront(task);
+			--m_dNumQueued;
+			++m_queues[thread]->numSteals;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool CTaskScheduler::TryProcessTask(int thread)
+{
+	STask task;
+	if (Pop(thread, task) || Steal(thread, task))
+	{
+		Execute(thread, task);
+		return true;
+	}
+	return false;
+}
+
+void CTaskScheduler::Execute(int thread, STask& task)
+{
+	auto start = std::chrono::steady_clock::now();
+	++s_dExecutionDepth;
+
+	if (task.range)
+	{
+		// The upper halves are left for the thieves, the lower one is processed right away
+		while (task.end - task.begin > task.batchSize)
+		{
+			int mid = task.begin + (task.end - task.begin) / 2;
+
+			STask upper = task;
+			upper.begin = mid;
+			Push(thread, upper);
+
+			task.end = mid;
+		}
+		task.range(task.pRangeContext, task.begin, task.end, thread);
+	}
+	else
+	{
+		task.func(task.pContext, thread);
+	}
+
+	SQueue& queue = *m_queues[thread];
+	if (--s_dExecutionDepth == 0)
+	{
+		queue.busyTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	}
+	++queue.numTasks;
+
+	// The group could be destroyed by the waiting thread right after this
+	--task.pGroup->m_dNumPending;
+}
+
+void CTaskScheduler::Run(CTaskGroup& group, TaskFunction func, void* pContext)
+{
+	STask task;
+	task.pGroup = &group;
+	task.func = func;
+	task.pContext = pContext;
+	Push(GetThreadIndex(), task);
+}
+
+void CTaskScheduler::Wait(CTaskGroup& group)
+{
+	while (!group.IsDone())
+	{
+		if (!ProcessTask())
+		{
+			// The rest of the group's tasks are being processed by the other threads
+			std::this_thread::yield();
+		}
+	}
+}
+
+bool CTaskScheduler::ProcessTask()
+{
+	const int thread = GetThreadIndex();
+	return thread >= 0 && TryProcessTask(thread);
+}
+
+void CTaskScheduler::ParallelFor(int count, int batchSize, RangeFunction func, const void* pContext)
+{
+	if (count <= 0)
+	{
+		return;
+	}
+
+	const int thread = GetThreadIndex();
+
+	batchSize = std::max(batchSize, 1);
+	if (thread >= 0 && (m_bSerial || GetNumThreads() == 1 || count <= batchSize))
+	{
+		func(pContext, 0, count, thread);
+		return;
+	}
+
+	CTaskGroup group;
+
+	STask range;
+	range.pGroup = &group;
+	range.range = func;
+	range.pRangeContext = pContext;
+	range.begin = 0;
+	range.end = count;
+	range.batchSize = batchSize;
+
+	// The threads not belonging to the scheduler leave the whole loop to the workers
+	if (thread < 0)
+	{
+		Push(thread, range);
+	}
+	else
+	{
+		++group.m_dNumPending;
+		Execute(thread, range);
+	}
+
+	Wait(group);
+}
+
+CTaskScheduler::SStatistics CTaskScheduler::GetStatistics(int thread) const
+{
+	SStatistics statistics;
+	if (thread >= 0 && thread < GetNumThreads())
+	{
+		const SQueue& queue = *m_queues[thread];
+		statistics.busyTime = sf::microseconds(queue.busyTime.load());
+		float fElapsed = m_statisticsClock.getElapsedTime().asSeconds();
+		statistics.fUtilization = fElapsed > 0.f ? statistics.busyTime.asSeconds() / fElapsed : 0.f;
+		statistics.numTasks = queue.numTasks.load();
+		statistics.numSteals = queue.numSteals.load();
+	}
+	return statistics;
+}
+
+void CTaskScheduler::ResetStatistics()
+{
+	for (auto& pQueue : m_queues)
+	{
+		pQueue->busyTime = 0;
+		pQueue->numTasks = 0;
+		pQueue->numSteals = 0;
+	}
+	m_statisticsClock.restart();
+}
+
+void CTaskScheduler::WorkerLoop(int thread)
+{
+	s_dThreadIndex = thread;
+
+	while (true)
+	{
+		if (TryProcessTask(thread))
+		{
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_sleepLock);
+		++m_dNumSleeping;
+		m_wakeSync.wait(lock, [this]() { return m_bStop || m_dNumQueued.load() > 0; });
+		--m_dNumSleeping;
+		if (m_bStop)
+		{
+			return;
+		}
+	}
+}
\ No newline at end of file
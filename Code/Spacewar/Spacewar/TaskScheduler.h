@@ -0,0 +1,214 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+
+#include <SFML/System/Time.hpp>
+#include <SFML/System/Clock.hpp>
+
+/**
+ * @class CTaskGroup
+ * The set of the tasks, which could be waited for together (see CTaskScheduler::Wait).
+ * The group must outlive all it's tasks.
+ */
+class CTaskGroup
+{
+	friend class CTaskScheduler;
+
+public:
+
+	CTaskGroup() = default;
+	CTaskGroup(const CTaskGroup&) = delete;
+
+	bool IsDone() const { return m_dNumPending.load() == 0; }
+
+private:
+
+	std::atomic<int> m_dNumPending = 0;
+};
+
+/**
+ * @class CTaskScheduler
+ * Engine-wide work-stealing task scheduler. Each thread has it's own deque of the tasks:
+ * the thread pushes and pops the tasks at the back of it's deque, so the latest tasks
+ * are processed first while their data is still in the cache, and the idle threads steal
+ * the oldest tasks from the front of the other deques. The ranges of the parallel loops
+ * are split in halves on the fly, so the stolen tasks are large and the busy threads keep
+ * the small ones. The main thread (the one which created the scheduler) is the thread 0,
+ * it takes part in the tasks processing while it waits for them. The worker threads sleep
+ * while there are no tasks. Any thread could wait for the tasks, but the threads
+ * not belonging to the scheduler don't process them. The tasks are the plain functions
+ * with their data and the deques are the ring buffers, which grow only when they are full,
+ * so scheduling the tasks doesn't allocate the memory in the steady state.
+ */
+class CTaskScheduler
+{
+public:
+
+	/**
+	 * The task body.
+	 *
+	 * @param pContext - the data of the task passed to Run.
+	 * @param thread - index of the thread processing the task. The main thread always has index 0,
+	 * so the index can be used to access the per thread data without synchronization.
+	 */
+	using TaskFunction = void (*)(void* pContext, int thread);
+
+	/**
+	 * The loop body.
+	 *
+	 * @param pContext - the data of the loop (see ParallelFor).
+	 * @param begin, end - the range of the loop indices to process.
+	 * @param thread - index of the thread processing the range (see TaskFunction).
+	 */
+	using RangeFunction = void (*)(const void* pContext, int begin, int end, int thread);
+
+	// The time spent on the tasks and the number of the processed and stolen tasks since the last reset
+	struct SStatistics
+	{
+		sf::Time busyTime;
+		// The busy time divided by the time passed since the last reset
+		float fUtilization = 0.f;
+		int numTasks = 0;
+		int numSteals = 0;
+	};
+
+	CTaskScheduler(int numWorkers);
+	CTaskScheduler(const CTaskScheduler&) = delete;
+	~CTaskScheduler();
+
+	// Number of the threads processing the tasks including the main thread
+	int GetNumThreads() const { return (int)m_queues.size(); }
+
+	// Index of the calling thread, -1 for the threads not belonging to the scheduler
+	int GetThreadIndex() const;
+
+	/**
+	 * @function Run
+	 * Schedule the task. The task is pushed into the calling thread's deque.
+	 *
+	 * @param group - group of the task.
+	 * @param func - the task body.
+	 * @param pContext - the data of the task, it must outlive the task.
+	 */
+	void Run(CTaskGroup& group, TaskFunction func, void* pContext);
+
+	/**
+	 * @function Wait
+	 * Wait until all the tasks of the group are done, processing any tasks meanwhile.
+	 *
+	 * @param group - group to wait for.
+	 */
+	void Wait(CTaskGroup& group);
+
+	/**
+	 * @function ProcessTask
+	 * Process one of the pending tasks on the calling thread.
+	 * It's useful for the threads waiting for something else than a task group.
+	 *
+	 * @return False if there are no tasks or the thread doesn't belong to the scheduler.
+	 */
+	bool ProcessTask();
+
+	/**
+	 * @function ParallelFor
+	 * Process the loop in parallel and wait until it's done.
+	 * Could be called from the tasks too. If there are no workers, the loop is processed
+	 * by the calling thread with it's own index. The threads not belonging to the scheduler
+	 * leave the whole loop to the scheduler's threads, even if it's only the main thread.
+	 *
+	 * @param count - number of the loop iterations.
+	 * @param batchSize - the ranges are not split further than this number of the iterations.
+	 * @param task - the loop body, called as task(begin, end, thread). It's passed to the tasks
+	 * by the pointer, so the loop never copies it.
+	 */
+	template <typename F>
+	void ParallelFor(int count, int batchSize, const F& task)
+	{
+		ParallelFor(count, batchSize, [](const void* pContext, int begin, int end, int thread)
+			{
+				(*static_cast<const F*>(pContext))(begin, end, thread);
+			}, &task);
+	}
+
+	void ParallelFor(int count, int batchSize, RangeFunction func, const void* pContext);
+
+	/**
+	 * @function SetSerial
+	 * Make ParallelFor process the whole loop on the calling thread, so nothing
+	 * is given to the workers. Should be called from the main thread while no tasks are run.
+	 */
+	void SetSerial(bool bSerial) { m_bSerial = bSerial; }
+
+	/**
+	 * @function GetStatistics
+	 * Get the counters of the thread since the last reset.
+	 * Should be called from the main thread, as well as ResetStatistics.
+	 *
+	 * @param thread - index of the thread.
+	 */
+	SStatistics GetStatistics(int thread) const;
+	void ResetStatistics();
+
+private:
+
+	struct STask
+	{
+		CTaskGroup* pGroup = nullptr;
+		TaskFunction func = nullptr;
+		void* pContext = nullptr;
+		// The range of the loop, if the task is a part of ParallelFor
+		RangeFunction range = nullptr;
+		const void* pRangeContext = nullptr;
+		int begin = 0;
+		int end = 0;
+		int batchSize = 1;
+	};
+
+	struct alignas(64) SQueue
+	{
+		std::mutex lock;
+
+		// The ring buffer of the tasks, the back is the latest task
+		std::vector<STask> tasks;
+		int first = 0;
+		int size = 0;
+
+		std::atomic<int64_t> busyTime = 0; // in microseconds
+		std::atomic<int> numTasks = 0;
+		std::atomic<int> numSteals = 0;
+
+		void PushBack(const STask& task);
+		void PopBack(STask& task);
+		void PopFront(STask& task);
+	};
+
+	void Push(int thread, const STask& task);
+	bool Pop(int thread, STask& task);
+	bool Steal(int thread, STask& task);
+
+	// Process one task of the thread's deque or a stolen one
+	bool TryProcessTask(int thread);
+	void Execute(int thread, STask& task);
+
+	void WorkerLoop(int thread);
+
+private:
+
+	std::vector<std::unique_ptr<SQueue>> m_queues;
+	std::vector<std::thread> m_workers;
+
+	std::atomic<int> m_dNumQueued = 0;
+	std::atomic<int> m_dNumSleeping = 0;
+	std::mutex m_sleepLock;
+	std::condition_variable m_wakeSync;
+	bool m_bStop = false;
+	bool m_bSerial = false;
+
+	sf::Clock m_statisticsClock;
+};
\ No newline at end of file